@@ -106,6 +106,25 @@ void set_compaction_manager(http_context& ctx, routes& r) {
         return make_ready_future<json::json_return_type>(json_void());
     });
 
+    cm::garbage_collect.set(r, [&ctx] (std::unique_ptr<request> req) {
+        auto keyspace = req->param["keyspace"];
+        if (!ctx.db.local().has_keyspace(keyspace)) {
+            throw bad_param_exception("Keyspace " + keyspace + " Does not exist");
+        }
+        auto column_families = split_cf(req->get_query_param("cf"));
+        if (column_families.empty()) {
+            column_families = map_keys(ctx.db.local().find_keyspace(keyspace).metadata().get()->cf_meta_data());
+        }
+        return ctx.db.invoke_on_all([keyspace, column_families] (database& db) {
+            auto& cm = db.get_compaction_manager();
+            return do_for_each(column_families, [&db, &cm, keyspace] (const sstring& cf) {
+                return cm.perform_garbage_collection(&db.find_column_family(keyspace, cf));
+            });
+        }).then([] {
+            return make_ready_future<json::json_return_type>(json_void());
+        });
+    });
+
     cm::stop_compaction.set(r, [&ctx] (std::unique_ptr<request> req) {
         auto type = req->get_query_param("type");
         return ctx.db.invoke_on_all([type] (database& db) {
@@ -28,6 +28,7 @@
 #include <cmath>
 
 #include "seastarx.hh"
+#include "utils/estimated_histogram.hh"
 
 // Simple proportional controller to adjust shares for processes for which a backlog can be clearly
 // defined.
@@ -135,16 +136,70 @@ class flush_controller : public backlog_controller {
     {}
 };
 
+// compaction CPU and I/O controller.
+//
+// The shares follow the compaction backlog, as for the flush controller. In addition, latency
+// goals can be set for foreground work. While the observed latency of any goal is above its
+// target, the backlog-derived shares are scaled down multiplicatively; once all goals are met
+// again, the scale grows back additively. This trades backlog clearing speed for foreground
+// latency, except when the backlog reaches the last control point: compaction has then fallen
+// so far behind that the full shares are given to it, or the backlog would grow without bound.
 class compaction_controller : public backlog_controller {
 public:
     static constexpr unsigned normalization_factor = 30;
     static constexpr float disable_backlog = std::numeric_limits<double>::infinity();
     static constexpr float backlog_disabled(float backlog) { return std::isinf(backlog); }
-    compaction_controller(seastar::scheduling_group sg, const ::io_priority_class& iop, float static_shares) : backlog_controller(sg, iop, static_shares) {}
+
+    // Foreground latency which compaction should not push above target.
+    struct latency_goal {
+        std::chrono::microseconds target;
+        float quantile = 0.99;
+        // Returns the cumulative latency histogram of the foreground work.
+        std::function<utils::time_estimated_histogram()> histogram;
+    };
+private:
+    static constexpr float min_latency_factor = 0.1f;
+    static constexpr float latency_backoff = 0.75f;
+    static constexpr float latency_recovery_step = 0.05f;
+
+    struct tracked_latency_goal {
+        latency_goal goal;
+        // Histogram at the previous adjustment, to look at the latency of the last interval only.
+        utils::time_estimated_histogram last;
+    };
+    std::vector<tracked_latency_goal> _latency_goals;
+    float _latency_factor = 1.0f;
+    float _latency_pressure = 0.0f;
+    float _shares;
+protected:
+    virtual void update_controller(float shares) override;
+public:
+    compaction_controller(seastar::scheduling_group sg, const ::io_priority_class& iop, float static_shares)
+        : backlog_controller(sg, iop, static_shares)
+        , _shares(static_shares)
+    {}
     compaction_controller(seastar::scheduling_group sg, const ::io_priority_class& iop, std::chrono::milliseconds interval, std::function<float()> current_backlog)
         : backlog_controller(sg, iop, std::move(interval),
           std::vector<backlog_controller::control_point>({{0.0, 50}, {1.5, 100} , {normalization_factor, 1000}}),
           std::move(current_backlog)
         )
+        , _shares(_control_points.front().output)
     {}
+
+    // Latency goals are only honored by the dynamic controller, not when static shares are used.
+    void set_latency_goals(std::vector<latency_goal> goals);
+
+    // Shares last given to compaction.
+    float shares() const {
+        return _shares;
+    }
+    // Scale applied to the backlog-derived shares to meet the latency goals, between
+    // min_latency_factor and 1.
+    float latency_factor() const {
+        return _latency_factor;
+    }
+    // Highest ratio of observed to target latency, over all goals, in the last interval.
+    float latency_pressure() const {
+        return _latency_pressure;
+    }
 };
@@ -93,6 +93,10 @@ class compaction_strategy {
             return "DateTieredCompactionStrategy";
         case compaction_strategy_type::time_window:
             return "TimeWindowCompactionStrategy";
+        case compaction_strategy_type::incremental:
+            return "IncrementalCompactionStrategy";
+        case compaction_strategy_type::unified:
+            return "UnifiedCompactionStrategy";
         default:
             throw std::runtime_error("Invalid Compaction Strategy");
         }
@@ -113,6 +117,10 @@ class compaction_strategy {
             return compaction_strategy_type::date_tiered;
         } else if (short_name == "TimeWindowCompactionStrategy") {
             return compaction_strategy_type::time_window;
+        } else if (short_name == "IncrementalCompactionStrategy") {
+            return compaction_strategy_type::incremental;
+        } else if (short_name == "UnifiedCompactionStrategy") {
+            return compaction_strategy_type::unified;
         } else {
             throw exceptions::configuration_exception(format("Unable to find compaction strategy class '{}'", name));
         }
@@ -148,6 +156,9 @@ class compaction_strategy {
     // SSTables that can be added into a single job.
     compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode);
 
+    // Returns whether the estimated ratio of droppable tombstones of a sstable, according to its
+    // metadata, is worth rewriting it alone for, as per the tombstone compaction options.
+    bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before);
 };
 
 // Creates a compaction_strategy object from one of the strategies available.
@@ -30,6 +30,8 @@ enum class compaction_strategy_type {
     leveled,
     date_tiered,
     time_window,
+    incremental,
+    unified,
 };
 
 enum class reshape_mode { strict, relaxed };
@@ -282,6 +282,7 @@ modes = {
 
 scylla_tests = set([
     'test/boost/UUID_test',
+    'test/boost/adaptive_concurrency_limiter_test',
     'test/boost/cdc_generation_test',
     'test/boost/aggregate_fcts_test',
     'test/boost/allocation_strategy_test',
@@ -290,6 +291,7 @@ scylla_tests = set([
     'test/boost/auth_passwords_test',
     'test/boost/auth_resource_test',
     'test/boost/auth_test',
+    'test/boost/backlog_controller_test',
     'test/boost/batchlog_manager_test',
     'test/boost/big_decimal_test',
     'test/boost/broken_sstable_test',
@@ -428,6 +430,7 @@ scylla_tests = set([
     'test/perf/memory_footprint_test',
     'test/perf/perf_cache_eviction',
     'test/perf/perf_cql_parser',
+    'test/perf/perf_cql_transport',
     'test/perf/perf_fast_forward',
     'test/perf/perf_hash',
     'test/perf/perf_mutation',
@@ -455,6 +458,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_sstable_set',
 ])
 
 raft_tests = set([
@@ -612,20 +616,26 @@ scylla_core = (['database.cc',
                 'sstables/compaction.cc',
                 'sstables/compaction_strategy.cc',
                 'sstables/size_tiered_compaction_strategy.cc',
+                'sstables/incremental_compaction_strategy.cc',
+                'sstables/unified_compaction_strategy.cc',
                 'sstables/leveled_compaction_strategy.cc',
                 'sstables/time_window_compaction_strategy.cc',
                 'sstables/compaction_manager.cc',
                 'sstables/integrity_checked_file_impl.cc',
+                'sstables/write_tracking_file_impl.cc',
                 'sstables/prepended_input_stream.cc',
                 'sstables/m_format_read_helpers.cc',
                 'sstables/sstable_directory.cc',
                 'sstables/random_access_reader.cc',
+                'sstables/partition_trie.cc',
+                'sstables/promoted_index_cache.cc',
                 'sstables/metadata_collector.cc',
                 'sstables/writer.cc',
                 'transport/cql_protocol_extension.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
                 'transport/server.cc',
+                'transport/segment.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
                 'cdc/cdc_partitioner.cc',
@@ -1016,6 +1026,7 @@ deps = {
 }
 
 pure_boost_tests = set([
+    'test/boost/adaptive_concurrency_limiter_test',
     'test/boost/anchorless_list_test',
     'test/boost/auth_passwords_test',
     'test/boost/auth_resource_test',
@@ -1114,6 +1125,7 @@ deps['test/boost/allocation_strategy_test'] = ['test/boost/allocation_strategy_t
 deps['test/boost/log_heap_test'] = ['test/boost/log_heap_test.cc']
 deps['test/boost/estimated_histogram_test'] = ['test/boost/estimated_histogram_test.cc']
 deps['test/boost/anchorless_list_test'] = ['test/boost/anchorless_list_test.cc']
+deps['test/boost/adaptive_concurrency_limiter_test'] = ['test/boost/adaptive_concurrency_limiter_test.cc']
 deps['test/perf/perf_fast_forward'] += ['release.cc']
 deps['test/perf/perf_simple_query'] += ['release.cc']
 deps['test/boost/reusable_buffer_test'] = [
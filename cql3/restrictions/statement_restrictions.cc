@@ -348,6 +348,77 @@ statement_restrictions::statement_restrictions(database& db,
     if (_uses_secondary_indexing && !(for_view || allow_filtering)) {
         validate_secondary_index_selections(selects_only_static_columns);
     }
+
+    prepare_key_eq_terms();
+}
+
+/// Returns the RHS of a `col = term` restriction, or null if the restriction has any other form.
+static ::shared_ptr<term> get_eq_term(const expr::expression& e) {
+    auto binop = std::get_if<expr::binary_operator>(&e);
+    if (!binop || binop->op != expr::oper_t::EQ) {
+        return nullptr;
+    }
+    auto cv = std::get_if<expr::column_value>(&binop->lhs);
+    if (!cv || cv->sub) {
+        return nullptr;
+    }
+    return binop->rhs;
+}
+
+void statement_restrictions::prepare_key_eq_terms() {
+    auto pk_restrictions = dynamic_pointer_cast<single_column_partition_key_restrictions>(_partition_key_restrictions);
+    if (pk_restrictions && !_uses_secondary_indexing
+            && pk_restrictions->size() == _schema->partition_key_size() && !pk_restrictions->needs_filtering(*_schema)) {
+        std::vector<::shared_ptr<term>> terms;
+        terms.reserve(pk_restrictions->size());
+        for (auto&& [def, r] : pk_restrictions->restrictions()) {
+            auto t = get_eq_term(r->expression);
+            if (!t) {
+                terms.clear();
+                break;
+            }
+            terms.push_back(std::move(t));
+        }
+        _partition_key_eq_terms = std::move(terms);
+    }
+
+    std::vector<::shared_ptr<term>> terms;
+    terms.reserve(_clustering_prefix_restrictions.size());
+    for (auto&& e : _clustering_prefix_restrictions) {
+        auto t = get_eq_term(e);
+        if (!t) {
+            return;
+        }
+        terms.push_back(std::move(t));
+    }
+    _clustering_prefix_eq_terms = std::move(terms);
+}
+
+/// Binds the given terms, returning std::nullopt if any of them is null, as no row can match a comparison
+/// with null.
+static std::optional<std::vector<bytes>> bind_eq_terms(const std::vector<::shared_ptr<term>>& terms, const query_options& options) {
+    std::vector<bytes> components;
+    components.reserve(terms.size());
+    for (auto&& t : terms) {
+        auto val = to_bytes_opt(t->bind_and_get(options));
+        if (!val) {
+            return std::nullopt;
+        }
+        components.push_back(std::move(*val));
+    }
+    return components;
+}
+
+std::optional<dht::partition_range_vector> statement_restrictions::get_partition_key_eq_ranges(const query_options& options) const {
+    if (_partition_key_eq_terms.empty()) {
+        return std::nullopt;
+    }
+    auto components = bind_eq_terms(_partition_key_eq_terms, options);
+    if (!components) {
+        return dht::partition_range_vector();
+    }
+    auto key = partition_key::from_exploded(*_schema, std::move(*components));
+    return dht::partition_range_vector{dht::partition_range::make_singular(dht::decorate_key(*_schema, std::move(key)))};
 }
 
 void statement_restrictions::add_restriction(::shared_ptr<restriction> restriction, bool for_view, bool allow_filtering) {
@@ -560,6 +631,9 @@ dht::partition_range_vector statement_restrictions::get_partition_key_ranges(con
     if (_partition_key_restrictions->needs_filtering(*_schema)) {
         return {dht::partition_range::make_open_ended_both_sides()};
     }
+    if (auto ranges = get_partition_key_eq_ranges(options)) {
+        return std::move(*ranges);
+    }
     return _partition_key_restrictions->bounds_ranges(options);
 }
 
@@ -1020,6 +1094,13 @@ std::vector<query::clustering_range> statement_restrictions::get_clustering_boun
     if (_clustering_prefix_restrictions.empty()) {
         return {query::clustering_range::make_open_ended_both_sides()};
     }
+    if (_clustering_prefix_eq_terms) {
+        auto components = bind_eq_terms(*_clustering_prefix_eq_terms, options);
+        if (!components) {
+            return {};
+        }
+        return {query::clustering_range::make_singular(clustering_key_prefix(std::move(*components)))};
+    }
     if (count_if(_clustering_prefix_restrictions[0], expr::is_multi_column)) {
         bool all_natural = true, all_reverse = true; ///< Whether column types are reversed or natural.
         for (auto& r : _clustering_prefix_restrictions) { // TODO: move to constructor, do only once.
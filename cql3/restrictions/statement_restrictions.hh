@@ -107,6 +107,14 @@ class statement_restrictions {
     std::optional<expr::expression> _where; ///< The entire WHERE clause.
     std::vector<expr::expression> _clustering_prefix_restrictions; ///< Parts of _where defining the clustering slice.
 
+    /// Right-hand sides of `pk = term` restrictions, in partition key order, when the partition key is fully
+    /// restricted by equalities and nothing else; empty otherwise.  Lets the common single-partition query build
+    /// its key straight from the bound values instead of re-evaluating the restrictions on every execution.
+    std::vector<::shared_ptr<term>> _partition_key_eq_terms;
+    /// Like _partition_key_eq_terms, for _clustering_prefix_restrictions made of equalities only.  Disengaged when
+    /// the clustering prefix has any other form.
+    std::optional<std::vector<::shared_ptr<term>>> _clustering_prefix_eq_terms;
+
 public:
     /**
      * Creates a new empty <code>StatementRestrictions</code>.
@@ -127,6 +135,8 @@ class statement_restrictions {
 
     void add_restriction(::shared_ptr<restriction> restriction, bool for_view, bool allow_filtering);
     void add_single_column_restriction(::shared_ptr<single_column_restriction> restriction, bool for_view, bool allow_filtering);
+private:
+    void prepare_key_eq_terms();
 public:
     const std::vector<::shared_ptr<restrictions>>& index_restrictions() const;
 
@@ -385,6 +395,13 @@ class statement_restrictions {
 public:
     std::vector<query::clustering_range> get_clustering_bounds(const query_options& options) const;
 
+    /**
+     * Returns the partition range of a query whose partition key is fully restricted by equalities (e.g.
+     * pk1 = ? AND pk2 = ?), built directly from the bound values, or std::nullopt if the partition key
+     * restrictions have any other form.
+     */
+    std::optional<dht::partition_range_vector> get_partition_key_eq_ranges(const query_options& options) const;
+
     /**
      * Checks if the query need to use filtering.
      * @return <code>true</code> if the query need to use filtering, <code>false</code> otherwise.
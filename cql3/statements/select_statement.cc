@@ -159,6 +159,18 @@ select_statement::select_statement(schema_ptr schema,
     _opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache());
     _opts.set_if<query::partition_slice::option::distinct>(_parameters->is_distinct());
     _opts.set_if<query::partition_slice::option::reversed>(_is_reversed);
+
+    if (_selection->contains_static_columns()) {
+        _static_columns.reserve(_selection->get_column_count());
+    }
+    _regular_columns.reserve(_selection->get_column_count());
+    for (auto&& col : _selection->get_columns()) {
+        if (col->is_static()) {
+            _static_columns.push_back(col->id);
+        } else if (col->is_regular()) {
+            _regular_columns.push_back(col->id);
+        }
+    }
 }
 
 db::timeout_clock::duration select_statement::get_timeout(const service::client_state& state, const query_options& options) const {
@@ -209,26 +221,9 @@ const sstring& select_statement::column_family() const {
 query::partition_slice
 select_statement::make_partition_slice(const query_options& options) const
 {
-    query::column_id_vector static_columns;
-    query::column_id_vector regular_columns;
-
-    if (_selection->contains_static_columns()) {
-        static_columns.reserve(_selection->get_column_count());
-    }
-
-    regular_columns.reserve(_selection->get_column_count());
-
-    for (auto&& col : _selection->get_columns()) {
-        if (col->is_static()) {
-            static_columns.push_back(col->id);
-        } else if (col->is_regular()) {
-            regular_columns.push_back(col->id);
-        }
-    }
-
     if (_parameters->is_distinct()) {
         return query::partition_slice({ query::clustering_range::make_open_ended_both_sides() },
-            std::move(static_columns), {}, _opts, nullptr, options.get_cql_serialization_format());
+            _static_columns, {}, _opts, nullptr, options.get_cql_serialization_format());
     }
 
     auto bounds =_restrictions->get_clustering_bounds(options);
@@ -244,7 +239,7 @@ select_statement::make_partition_slice(const query_options& options) const
         ++_stats.reverse_queries;
     }
     return query::partition_slice(std::move(bounds),
-        std::move(static_columns), std::move(regular_columns), _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
+        _static_columns, _regular_columns, _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
 }
 
 uint64_t select_statement::do_get_limit(const query_options& options, ::shared_ptr<term> limit, uint64_t default_limit) const {
@@ -733,30 +728,38 @@ indexed_table_select_statement::process_base_query_results(
 {
     if (paging_state) {
         paging_state = generate_view_paging_state_from_base_query_results(paging_state, results, proxy, state, options);
-        _selection->get_result_metadata()->maybe_set_paging_state(std::move(paging_state));
     }
-    return process_results(std::move(results), std::move(cmd), options, now);
+    return process_results(std::move(results), std::move(cmd), options, now, std::move(paging_state));
 }
 
 future<shared_ptr<cql_transport::messages::result_message>>
 select_statement::process_results(foreign_ptr<lw_shared_ptr<query::result>> results,
                                   lw_shared_ptr<query::read_command> cmd,
                                   const query_options& options,
-                                  gc_clock::time_point now) const
+                                  gc_clock::time_point now,
+                                  lw_shared_ptr<const service::pager::paging_state> paging_state) const
 {
     const bool restrictions_need_filtering = _restrictions->need_filtering();
     const bool fast_path = !needs_post_query_ordering() && _selection->is_trivial() && !restrictions_need_filtering;
     if (fast_path) {
+        // The result metadata of the selection is shared by all executions of
+        // the statement, so it is never modified; a paging state goes to a copy.
+        shared_ptr<const cql3::metadata> meta = _selection->get_result_metadata();
+        if (paging_state) {
+            auto copy = ::make_shared<metadata>(*meta);
+            copy->maybe_set_paging_state(std::move(paging_state));
+            meta = std::move(copy);
+        }
         return make_ready_future<shared_ptr<cql_transport::messages::result_message>>(make_shared<cql_transport::messages::result_message::rows>(result(
             result_generator(_schema, std::move(results), std::move(cmd), _selection, _stats),
-            ::make_shared<metadata>(*_selection->get_result_metadata()))
+            std::move(meta))
         ));
     }
 
     cql3::selection::result_set_builder builder(*_selection, now,
             options.get_cql_serialization_format());
-    return do_with(std::move(builder), [this, cmd, restrictions_need_filtering, results = std::move(results), options] (cql3::selection::result_set_builder& builder) mutable {
-        return builder.with_thread_if_needed([this, &builder, cmd, restrictions_need_filtering, results = std::move(results), options] {
+    return do_with(std::move(builder), [this, cmd, restrictions_need_filtering, results = std::move(results), options, paging_state = std::move(paging_state)] (cql3::selection::result_set_builder& builder) mutable {
+        return builder.with_thread_if_needed([this, &builder, cmd, restrictions_need_filtering, results = std::move(results), options, paging_state = std::move(paging_state)] () mutable {
             if (restrictions_need_filtering) {
                 results->ensure_counts();
                 _stats.filtered_rows_read_total += *results->row_count();
@@ -769,6 +772,9 @@ select_statement::process_results(foreign_ptr<lw_shared_ptr<query::result>> resu
                                 *_selection));
             }
             auto rs = builder.build();
+            if (paging_state) {
+                rs->get_metadata().maybe_set_paging_state(std::move(paging_state));
+            }
 
             if (needs_post_query_ordering()) {
                 rs->sort(_ordering_comparator);
@@ -92,6 +92,9 @@ class select_statement : public cql_statement {
     ordering_comparator_type _ordering_comparator;
 
     query::partition_slice::option_set _opts;
+    // Columns read by the query, resolved from the selection once at prepare time.
+    query::column_id_vector _static_columns;
+    query::column_id_vector _regular_columns;
     cql_stats& _stats;
     const ks_selector _ks_sel;
     bool _range_scan = false;
@@ -135,7 +138,8 @@ protected :
     };
 
     future<shared_ptr<cql_transport::messages::result_message>> process_results(foreign_ptr<lw_shared_ptr<query::result>> results,
-        lw_shared_ptr<query::read_command> cmd, const query_options& options, gc_clock::time_point now) const;
+        lw_shared_ptr<query::read_command> cmd, const query_options& options, gc_clock::time_point now,
+        lw_shared_ptr<const service::pager::paging_state> paging_state = nullptr) const;
 
     const sstring& keyspace() const;
 
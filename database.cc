@@ -461,6 +461,40 @@ void backlog_controller::update_controller(float shares) {
     _inflight_update = engine().update_shares_for_class(_io_priority, uint32_t(shares));
 }
 
+void compaction_controller::set_latency_goals(std::vector<latency_goal> goals) {
+    _latency_goals.clear();
+    for (auto& goal : goals) {
+        auto last = goal.histogram();
+        _latency_goals.push_back(tracked_latency_goal{std::move(goal), std::move(last)});
+    }
+    _latency_factor = 1.0f;
+    _latency_pressure = 0.0f;
+}
+
+void compaction_controller::update_controller(float shares) {
+    if (!_latency_goals.empty()) {
+        _latency_pressure = 0.0f;
+        for (auto& g : _latency_goals) {
+            auto current = g.goal.histogram();
+            auto window = current;
+            window.subtract(g.last);
+            g.last = std::move(current);
+            auto latency = window.quantile(g.goal.quantile);
+            _latency_pressure = std::max(_latency_pressure, float(latency) / g.goal.target.count());
+        }
+        if (_latency_pressure > 1.0f) {
+            _latency_factor = std::max(_latency_factor * latency_backoff, min_latency_factor);
+        } else {
+            _latency_factor = std::min(_latency_factor + latency_recovery_step, 1.0f);
+        }
+        if (shares < _control_points.back().output) {
+            shares = std::max(shares * _latency_factor, _control_points.front().output);
+        }
+    }
+    _shares = shares;
+    backlog_controller::update_controller(shares);
+}
+
 void
 dirty_memory_manager::setup_collectd(sstring namestr) {
     namespace sm = seastar::metrics;
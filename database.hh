@@ -438,6 +438,13 @@ class table : public enable_lw_shared_from_this<table> {
     // sstables that should not be compacted (e.g. because they need to be used
     // to generate view updates later)
     std::unordered_map<uint64_t, sstables::shared_sstable> _sstables_staging;
+    // sstables added off-strategy, e.g. by repair and streaming. They are
+    // visible to reads but not to the compaction strategy, until off-strategy
+    // compaction reshapes them into the table's layout; see run_offstrategy_compaction().
+    std::unordered_set<sstables::shared_sstable> _sstables_maintenance;
+    // Triggers off-strategy compaction once no sstable was added off-strategy for a while.
+    timer<lowres_clock> _offstrategy_trigger;
+    static constexpr std::chrono::minutes offstrategy_quiet_period{5};
     // Control background fibers waiting for sstables to be deleted
     seastar::gate _sstable_deletion_gate;
     // This semaphore ensures that an operation like snapshot won't have its selected
@@ -503,7 +510,7 @@ class table : public enable_lw_shared_from_this<table> {
 
     bool _is_bootstrap_or_replace = false;
 public:
-    future<> add_sstable_and_update_cache(sstables::shared_sstable sst);
+    future<> add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy = sstables::offstrategy::no);
     future<> move_sstables_from_staging(std::vector<sstables::shared_sstable>);
     sstables::shared_sstable get_staging_sstable(uint64_t generation) {
         auto it = _sstables_staging.find(generation);
@@ -535,7 +542,7 @@ class table : public enable_lw_shared_from_this<table> {
     // Cache must be synchronized atomically with this, otherwise write atomicity may not be respected.
     // Doesn't trigger compaction.
     // Strong exception guarantees.
-    void add_sstable(sstables::shared_sstable sstable);
+    void add_sstable(sstables::shared_sstable sstable, sstables::offstrategy offstrategy = sstables::offstrategy::no);
     static void add_sstable_to_backlog_tracker(compaction_backlog_tracker& tracker, sstables::shared_sstable sstable);
     static void remove_sstable_from_backlog_tracker(compaction_backlog_tracker& tracker, sstables::shared_sstable sstable);
     void load_sstable(sstables::shared_sstable& sstable, bool reset_level = false);
@@ -828,6 +835,11 @@ class table : public enable_lw_shared_from_this<table> {
     const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const;
     std::vector<sstables::shared_sstable> select_sstables(const dht::partition_range& range) const;
     std::vector<sstables::shared_sstable> non_staging_sstables() const;
+    // sstables which are subject to the compaction strategy, i.e. neither staging nor maintenance ones.
+    std::vector<sstables::shared_sstable> in_strategy_sstables() const;
+    size_t maintenance_sstables_count() const {
+        return _sstables_maintenance.size();
+    }
     size_t sstables_count() const;
     std::vector<uint64_t> sstable_count_per_level() const;
     int64_t get_unleveled_sstables() const;
@@ -835,6 +847,12 @@ class table : public enable_lw_shared_from_this<table> {
     void start_compaction();
     void trigger_compaction();
     void try_trigger_compaction() noexcept;
+    // Schedules off-strategy compaction of the maintenance sstables, if any.
+    void trigger_offstrategy_compaction();
+    // Reshapes the maintenance sstables into the table's layout and hands them over
+    // to the compaction strategy. Runs under the compaction manager, see
+    // compaction_manager::perform_offstrategy().
+    future<> run_offstrategy_compaction();
     future<> run_compaction(sstables::compaction_descriptor descriptor);
     void set_compaction_strategy(sstables::compaction_strategy_type strategy);
     const sstables::compaction_strategy& get_compaction_strategy() const {
@@ -221,6 +221,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
         "If set to true, enforce the min_threshold option for compactions strictly. If false (default), Scylla may decide to compact even if below min_threshold")
+    , compaction_read_latency_target_in_ms(this, "compaction_read_latency_target_in_ms", value_status::Used, 0,
+        "Target for the 99th percentile latency of reads in the statement scheduling group. While it is exceeded, the compaction controller gives compaction fewer shares than its backlog calls for, unless the backlog reaches its maximum. 0 (default) disables the target. Ignored when compaction_static_shares is set.")
+    , compaction_write_latency_target_in_ms(this, "compaction_write_latency_target_in_ms", value_status::Used, 0,
+        "Target for the 99th percentile latency of writes in the statement scheduling group, see compaction_read_latency_target_in_ms. 0 (default) disables the target.")
     /* Initialization properties */
     /* The minimal properties needed for configuring a cluster. */
     , cluster_name(this, "cluster_name", value_status::Used, "",
@@ -745,6 +749,17 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+    , lazy_load_sstable_components(this, "lazy_load_sstable_components", value_status::Used, true, "Open sstables found on disk without their Filter and Summary entries, which are then loaded on first access or by a background pass, one sstable at a time."
+        " Shortens startup of nodes with many sstables.")
+    , enable_sstable_partition_trie(this, "enable_sstable_partition_trie", value_status::Used, false, "Write a Partitions component with a trie of the partition keys along with mc and md sstables."
+        " Single-partition reads use it to find the partition in the index without going through the summary. Older versions ignore the component.")
+    , sstable_partition_trie_cache_size_in_kb(this, "sstable_partition_trie_cache_size_in_kb", value_status::Used, 64, "Memory per sstable for keeping the pages of its Partitions component which are closest to the root of the trie, shared by all reads of the sstable.")
+    , promoted_index_cache_size_in_mb(this, "promoted_index_cache_size_in_mb", value_status::Used, 16, "Memory per shard for keeping the parsed promoted index blocks of recently read wide partitions, so that later reads of the same partition don't parse them again."
+        " Set to 0 to keep the blocks only for the duration of a read.")
+    , sstable_write_buffer_size_in_kb(this, "sstable_write_buffer_size_in_kb", value_status::Used, 512, "Size of the writes to the Data component of sstables being written."
+        " Rounded up to a multiple of the write alignment of the disk and of 64 KB.")
+    , sstable_write_in_flight_size_in_kb(this, "sstable_write_in_flight_size_in_kb", value_status::Used, 2048, "Amount of data each sstable writer keeps in flight to the Data component, in writes of sstable_write_buffer_size_in_kb."
+        " At least two writes are kept in flight.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Used, true, "Enable SSTables 'mc' format to be used as the default file format")
@@ -780,6 +795,13 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Time period in seconds after which unused schema versions will be evicted from the local schema registry cache. Default is 1 second.")
     , max_concurrent_requests_per_shard(this, "max_concurrent_requests_per_shard",liveness::LiveUpdate, value_status::Used, std::numeric_limits<uint32_t>::max(),
         "Maximum number of concurrent requests a single shard can handle before it starts shedding extra load. By default, no requests will be shed.")
+    , cql_adaptive_concurrency_limit(this, "cql_adaptive_concurrency_limit", liveness::LiveUpdate, value_status::Used, false,
+        "Limit the number of concurrent CQL requests per shard and scheduling group adaptively, based on the observed request latency. "
+        "Requests above the limit are rejected immediately with an Overloaded error, instead of being queued until they time out.")
+    , cql_adaptive_concurrency_limit_min(this, "cql_adaptive_concurrency_limit_min", value_status::Used, 16,
+        "The lowest value the adaptive CQL concurrency limit can reach (see cql_adaptive_concurrency_limit).")
+    , cql_adaptive_concurrency_limit_max(this, "cql_adaptive_concurrency_limit_max", value_status::Used, 10000,
+        "The highest value the adaptive CQL concurrency limit can reach (see cql_adaptive_concurrency_limit).")
     , cdc_dont_rewrite_streams(this, "cdc_dont_rewrite_streams", value_status::Used, false,
             "Disable rewriting streams from cdc_streams_descriptions to cdc_streams_descriptions_v2. Should not be necessary, but the procedure is expensive and prone to failures; this config option is left as a backdoor in case some user requires manual intervention.")
     , alternator_port(this, "alternator_port", value_status::Used, 0, "Alternator API port")
@@ -127,6 +127,8 @@ class config : public utils::config_file {
     named_value<float> memtable_flush_static_shares;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
+    named_value<uint32_t> compaction_read_latency_target_in_ms;
+    named_value<uint32_t> compaction_write_latency_target_in_ms;
     named_value<sstring> cluster_name;
     named_value<sstring> listen_address;
     named_value<sstring> listen_interface;
@@ -302,6 +304,12 @@ class config : public utils::config_file {
     named_value<bool> enable_keyspace_column_family_metrics;
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> enable_sstable_key_validation;
+    named_value<bool> lazy_load_sstable_components;
+    named_value<bool> enable_sstable_partition_trie;
+    named_value<uint32_t> sstable_partition_trie_cache_size_in_kb;
+    named_value<uint32_t> promoted_index_cache_size_in_mb;
+    named_value<uint32_t> sstable_write_buffer_size_in_kb;
+    named_value<uint32_t> sstable_write_in_flight_size_in_kb;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
     named_value<bool> enable_sstables_mc_format;
@@ -322,6 +330,9 @@ class config : public utils::config_file {
     named_value<unsigned> user_defined_function_contiguous_allocation_limit_bytes;
     named_value<uint32_t> schema_registry_grace_period;
     named_value<uint32_t> max_concurrent_requests_per_shard;
+    named_value<bool> cql_adaptive_concurrency_limit;
+    named_value<uint32_t> cql_adaptive_concurrency_limit_min;
+    named_value<uint32_t> cql_adaptive_concurrency_limit_max;
     named_value<bool> cdc_dont_rewrite_streams;
 
     named_value<uint16_t> alternator_port;
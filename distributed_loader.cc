@@ -31,10 +31,12 @@
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/sstable_directory.hh"
+#include "sstables/sstable_set.hh"
 #include "service/priority_manager.hh"
 #include "auth/common.hh"
 #include "tracing/trace_keyspace_helper.hh"
 #include "db/view/view_update_checks.hh"
+#include "mutation_writer/multishard_writer.hh"
 #include <unordered_map>
 #include <boost/range/adaptor/map.hpp>
 #include "db/view/view_update_generator.hh"
@@ -161,6 +163,20 @@ distributed_loader::process_sstable_dir(sharded<sstables::sstable_directory>& di
             return d.move_foreign_sstables(dir);
         });
       });
+    }).then([&dir] {
+        // Shards process the directory in parallel, so the slowest one tells how long each phase took.
+        using process_stats = sstables::sstable_directory::process_stats;
+        return dir.map_reduce0(std::mem_fn(&sstables::sstable_directory::get_process_stats), process_stats{}, [] (process_stats a, const process_stats& b) {
+            a.sstables += b.sstables;
+            a.listing = std::max(a.listing, b.listing);
+            a.loading = std::max(a.loading, b.loading);
+            a.sorting = std::max(a.sorting, b.sorting);
+            return a;
+        }).then([&dir] (process_stats stats) {
+            using secs = std::chrono::duration<double>;
+            dblog.info("Processed {} SSTables in {}: listing {:.3f}s, loading {:.3f}s, sorting {:.3f}s on the slowest shard",
+                    stats.sstables, dir.local().sstable_dir().native(), secs(stats.listing).count(), secs(stats.loading).count(), secs(stats.sorting).count());
+        });
     }).then([&dir] {
         return dir.invoke_on_all([&dir] (sstables::sstable_directory& d) {
             return d.commit_directory_changes();
@@ -482,6 +498,75 @@ distributed_loader::get_sstables_from_upload_dir(distributed<database>& db, sstr
     });
 }
 
+future<uint64_t>
+distributed_loader::load_and_distribute(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+        distributed<db::view::view_update_generator>& view_update_generator, utils::UUID table_id, std::vector<sstables::shared_sstable> sstables) {
+    seastar::thread_attributes attr;
+    attr.sched_group = db.local().get_streaming_scheduling_group();
+
+    return seastar::async(std::move(attr), [&db, &sys_dist_ks, &view_update_generator, table_id, sstables = std::move(sstables)] () mutable {
+        if (sstables.empty()) {
+            return uint64_t(0);
+        }
+        auto& table = db.local().find_column_family(table_id);
+        auto s = table.schema();
+        auto sst_set = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s,
+                make_lw_shared<sstable_list>(sstable_list{}), false));
+        uint64_t estimated_partitions = 0;
+        for (auto& sst : sstables) {
+            estimated_partitions += sst->get_estimated_key_count();
+            sst_set->insert(sst);
+        }
+        // Partitions are spread evenly among shards by their tokens.
+        estimated_partitions = std::max(estimated_partitions / smp::count, uint64_t(1));
+
+        // The reader keeps a reference to the range, which has to outlive it.
+        const auto full_partition_range = dht::partition_range::make_open_ended_both_sides();
+        auto start_time = std::chrono::steady_clock::now();
+        auto reader = table.make_streaming_reader(s, full_partition_range, sst_set);
+        auto partitions = mutation_writer::distribute_reader_and_consume_on_shards(s, std::move(reader),
+                [&db, &sys_dist_ks, &view_update_generator, estimated_partitions] (flat_mutation_reader reader) {
+            auto& cf = db.local().find_column_family(reader.schema());
+            return db::view::check_needs_view_update_path(sys_dist_ks.local(), cf, streaming::stream_reason::repair).then(
+                    [&view_update_generator, cf = cf.shared_from_this(), estimated_partitions, reader = std::move(reader)] (bool use_view_update_path) mutable {
+                auto metadata = mutation_source_metadata{};
+                auto& cs = cf->get_compaction_strategy();
+                const auto adjusted_estimated_partitions = cs.adjust_partition_estimate(metadata, estimated_partitions);
+                auto consumer = cs.make_interposer_consumer(metadata,
+                        [&view_update_generator, cf = std::move(cf), adjusted_estimated_partitions, use_view_update_path] (flat_mutation_reader reader) {
+                    sstables::shared_sstable sst = use_view_update_path ? cf->make_streaming_staging_sstable() : cf->make_streaming_sstable_for_write();
+                    schema_ptr s = reader.schema();
+                    auto& pc = service::get_local_streaming_priority();
+
+                    return sst->write_components(std::move(reader), adjusted_estimated_partitions, s,
+                                                 cf->get_sstables_manager().configure_writer("upload"),
+                                                 encoding_stats{}, pc).then([sst] {
+                        return sst->open_data();
+                    }).then([cf, sst, use_view_update_path] {
+                        return cf->add_sstable_and_update_cache(sst, sstables::offstrategy(!use_view_update_path));
+                    }).then([&view_update_generator, cf, sst, use_view_update_path] () mutable -> future<> {
+                        if (!use_view_update_path) {
+                            return make_ready_future<>();
+                        }
+                        return view_update_generator.local().register_staging_sstable(sst, std::move(cf));
+                    });
+                });
+                return consumer(std::move(reader));
+            });
+        }, table.stream_in_progress()).get0();
+
+        // Everything the sstables hold was written elsewhere, so they can go.
+        parallel_for_each(sstables, [] (sstables::shared_sstable& sst) {
+            return sst->unlink();
+        }).get();
+
+        auto duration = std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - start_time);
+        dblog.info("Loaded {} partitions of {} SSTables into {}.{} in {:.2f} seconds", partitions, sstables.size(),
+                s->ks_name(), s->cf_name(), duration.count());
+        return partitions;
+    });
+}
+
 future<> distributed_loader::cleanup_column_family_temp_sst_dirs(sstring sstdir) {
     return do_with(std::vector<future<>>(), [sstdir = std::move(sstdir)] (std::vector<future<>>& futures) {
         return lister::scan_dir(sstdir, { directory_entry_type::directory }, [&futures] (fs::path sstdir, directory_entry de) {
@@ -78,6 +78,12 @@ class distributed_loader {
     // The table UUID is returned too.
     static future<std::tuple<utils::UUID, std::vector<std::vector<sstables::shared_sstable>>>>
             get_sstables_from_upload_dir(distributed<database>& db, sstring ks, sstring cf);
+    // Reads the given sstables, as returned for this shard by get_sstables_from_upload_dir(), once
+    // and writes each of their partitions into new sstables of the shard owning it, which are then
+    // added to the table, without resharding or reshaping them first. The given sstables are removed
+    // once they are loaded. Returns the number of partitions loaded.
+    static future<uint64_t> load_and_distribute(distributed<database>& db, distributed<db::system_distributed_keyspace>& sys_dist_ks,
+            distributed<db::view::view_update_generator>& view_update_generator, utils::UUID table_id, std::vector<sstables::shared_sstable> sstables);
     static future<> populate_column_family(distributed<database>& db, sstring sstdir, sstring ks, sstring cf);
     static future<> populate_keyspace(distributed<database>& db, sstring datadir, sstring ks_name);
     static future<> init_system_keyspace(distributed<database>& db);
@@ -906,6 +906,21 @@ int main(int ac, char** av) {
             proxy.start(std::ref(db), spcfg, std::ref(node_backlog),
                     scheduling_group_key_create(storage_proxy_stats_cfg).get0(),
                     std::ref(feature_service), std::ref(token_metadata), std::ref(messaging)).get();
+            db.invoke_on_all([&proxy, sg = dbcfg.statement_scheduling_group,
+                    read_target = cfg->compaction_read_latency_target_in_ms(),
+                    write_target = cfg->compaction_write_latency_target_in_ms()] (database& db) {
+                auto stats = [&proxy, sg] () -> service::storage_proxy_stats::stats& {
+                    return scheduling_group_get_specific<service::storage_proxy_stats::stats>(sg, proxy.local().get_stats_key());
+                };
+                std::vector<compaction_controller::latency_goal> goals;
+                if (read_target) {
+                    goals.push_back({std::chrono::milliseconds(read_target), 0.99, [stats] { return stats().estimated_read; }});
+                }
+                if (write_target) {
+                    goals.push_back({std::chrono::milliseconds(write_target), 0.99, [stats] { return stats().estimated_write; }});
+                }
+                db.get_compaction_manager().set_latency_goals(std::move(goals));
+            }).get();
             // #293 - do not stop anything
             // engine().at_exit([&proxy] { return proxy.stop(); });
             supervisor::notify("starting migration manager");
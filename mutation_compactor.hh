@@ -153,6 +153,9 @@ class compact_mutation_state {
     std::optional<static_row> _last_static_row;
 
     std::unique_ptr<mutation_compactor_garbage_collector> _collector;
+
+    // Partition, row and range tombstones purged so far.
+    uint64_t _purged_tombstones = 0;
 private:
     static constexpr bool only_live() {
         return OnlyLive == emit_only_live_rows::yes;
@@ -268,6 +271,7 @@ class compact_mutation_state {
         _range_tombstones.set_partition_tombstone(t);
         if (!only_live()) {
             if (can_purge_tombstone(t)) {
+                ++_purged_tombstones;
                 partition_is_not_empty_for_gc_consumer(gc_consumer);
             } else {
                 partition_is_not_empty(consumer);
@@ -324,6 +328,7 @@ class compact_mutation_state {
                     _collector->collect(rt);
                 }
                 cr.remove_tombstone();
+                ++_purged_tombstones;
             }
         }
 
@@ -371,6 +376,7 @@ class compact_mutation_state {
         // FIXME: drop tombstone if it is fully covered by other range tombstones
         if (rt.tomb > _range_tombstones.get_partition_tombstone()) {
             if (can_purge_tombstone(rt.tomb)) {
+                ++_purged_tombstones;
                 partition_is_not_empty_for_gc_consumer(gc_consumer);
                 return gc_consumer.consume(std::move(rt));
             } else {
@@ -458,6 +464,12 @@ class compact_mutation_state {
         return _row_limit == 0 || _partition_limit == 0;
     }
 
+    /// The number of partition, row and range tombstones purged so far.
+    /// Cell tombstones are not included.
+    uint64_t purged_tombstones() const {
+        return _purged_tombstones;
+    }
+
     /// Detach the internal state of the compactor
     ///
     /// The state is represented by the last seen partition header, static row
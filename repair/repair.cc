@@ -1563,6 +1563,13 @@ static future<> repair_ranges(lw_shared_ptr<repair_info> ri) {
     return do_repair_ranges(ri).then([ri] {
         ri->check_failed_ranges();
         repair_tracker().remove_repair_info(ri->id.id);
+        // Don't wait for the quiet period of the sstables repair added off-strategy.
+        for (auto& table_id : ri->table_ids) {
+            try {
+                ri->db.local().find_column_family(table_id).trigger_offstrategy_compaction();
+            } catch (no_such_column_family&) {
+            }
+        }
         return make_ready_future<>();
     }).handle_exception([ri] (std::exception_ptr eptr) {
         rlogger.warn("repair id {} on shard {} failed: {}", ri->id, this_shard_id(), eptr);
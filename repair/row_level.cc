@@ -589,8 +589,8 @@ class repair_writer : public enable_lw_shared_from_this<repair_writer> {
                                                  t->get_sstables_manager().configure_writer("repair"),
                                                  encoding_stats{}, pc).then([sst] {
                         return sst->open_data();
-                    }).then([t, sst] {
-                        return t->add_sstable_and_update_cache(sst);
+                    }).then([t, sst, use_view_update_path] {
+                        return t->add_sstable_and_update_cache(sst, sstables::offstrategy(!use_view_update_path));
                     }).then([t, s, sst, use_view_update_path]() mutable -> future<> {
                         if (!use_view_update_path) {
                             return make_ready_future<>();
@@ -57,6 +57,7 @@ thread_local api::timestamp_type service::client_state::_last_timestamp_micros =
 
 void service::client_state::set_login(auth::authenticated_user user) {
     _user = std::move(user);
+    ++_generation;
 }
 
 future<> service::client_state::check_user_can_login() {
@@ -259,6 +260,7 @@ void service::client_state::set_keyspace(database& db, std::string_view keyspace
         throw exceptions::invalid_request_exception(format("Keyspace '{}' does not exist", keyspace));
     }
     _keyspace = sstring(keyspace);
+    ++_generation;
 }
 
 future<> service::client_state::ensure_exists(const auth::resource& r) const {
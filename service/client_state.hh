@@ -86,6 +86,11 @@ class client_state {
         client_state get() const {
             return client_state(_cs, _auth_service);
         }
+        // A copy obtained with get() is up to date as long as its generation
+        // matches this one.
+        uint64_t generation() const {
+            return _cs->_generation;
+        }
     };
 private:
     client_state(const client_state* cs, seastar::sharded<auth::service>* auth_service)
@@ -99,6 +104,7 @@ class client_state {
             , _default_timeout_config(cs->_default_timeout_config)
             , _timeout_config(cs->_timeout_config)
             , _enabled_protocol_extensions(cs->_enabled_protocol_extensions)
+            , _generation(cs->_generation)
     {}
     friend client_state_for_another_shard;
 private:
@@ -158,6 +164,7 @@ class client_state {
 
     void set_auth_state(auth_state new_state) noexcept {
         _auth_state = new_state;
+        ++_generation;
     }
 
     std::optional<sstring> get_driver_name() const {
@@ -306,15 +313,12 @@ class client_state {
         return _keyspace;
     }
 
-    sstring& get_raw_keyspace() noexcept {
-        return _keyspace;
-    }
-
 public:
     void set_keyspace(database& db, std::string_view keyspace);
 
     void set_raw_keyspace(sstring new_keyspace) noexcept {
         _keyspace = std::move(new_keyspace);
+        ++_generation;
     }
 
     const sstring& get_keyspace() const {
@@ -402,6 +406,10 @@ class client_state {
 
     cql_transport::cql_protocol_extension_enum_set _enabled_protocol_extensions;
 
+    // Incremented whenever state that is copied by move_to_other_shard()
+    // changes, so that copies cached on other shards can be refreshed.
+    uint64_t _generation = 0;
+
 public:
 
     bool is_protocol_extension_set(cql_transport::cql_protocol_extension ext) const {
@@ -410,6 +418,11 @@ class client_state {
 
     void set_protocol_extensions(cql_transport::cql_protocol_extension_enum_set exts) {
         _enabled_protocol_extensions = std::move(exts);
+        ++_generation;
+    }
+
+    uint64_t generation() const noexcept {
+        return _generation;
     }
 };
 
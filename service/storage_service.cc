@@ -2717,14 +2717,14 @@ future<> storage_service::load_and_stream(sstring ks_name, sstring cf_name,
 // All the global operations are going to happen here, and just the reloading happens
 // in there.
 future<> storage_service::load_new_sstables(sstring ks_name, sstring cf_name,
-    bool load_and_stream, bool primary_replica_only) {
+    bool load_and_stream, bool primary_replica_only, bool load_and_distribute) {
     if (_loading_new_sstables) {
         throw std::runtime_error("Already loading SSTables. Try again later");
     } else {
         _loading_new_sstables = true;
     }
-    slogger.info("Loading new SSTables for keyspace={}, table={}, load_and_stream={}, primary_replica_only={}",
-            ks_name, cf_name, load_and_stream, primary_replica_only);
+    slogger.info("Loading new SSTables for keyspace={}, table={}, load_and_stream={}, primary_replica_only={}, load_and_distribute={}",
+            ks_name, cf_name, load_and_stream, primary_replica_only, load_and_distribute);
     try {
         if (load_and_stream) {
             utils::UUID table_id;
@@ -2733,6 +2733,14 @@ future<> storage_service::load_new_sstables(sstring ks_name, sstring cf_name,
             co_await container().invoke_on_all([&sstables_on_shards, ks_name, cf_name, table_id, primary_replica_only] (storage_service& ss) mutable -> future<> {
                 co_await ss.load_and_stream(ks_name, cf_name, table_id, std::move(sstables_on_shards[this_shard_id()]), primary_replica_only);
             });
+        } else if (load_and_distribute) {
+            utils::UUID table_id;
+            std::vector<std::vector<sstables::shared_sstable>> sstables_on_shards;
+            std::tie(table_id, sstables_on_shards) = co_await distributed_loader::get_sstables_from_upload_dir(_db, ks_name, cf_name);
+            co_await container().invoke_on_all([&sstables_on_shards, table_id] (storage_service& ss) -> future<> {
+                co_await distributed_loader::load_and_distribute(ss._db, ss._sys_dist_ks, ss._view_update_generator, table_id,
+                        std::move(sstables_on_shards[this_shard_id()]));
+            });
         } else {
             co_await distributed_loader::process_upload_dir(_db, _sys_dist_ks, _view_update_generator, ks_name, cf_name);
         }
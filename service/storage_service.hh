@@ -851,10 +851,12 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
      *
      * @param ks_name the keyspace in which to search for new SSTables.
      * @param cf_name the column family in which to search for new SSTables.
+     * @param load_and_distribute write the partitions of the new SSTables straight into SSTables of
+     *        their owning shards, instead of resharding and reshaping them first.
      * @return a future<> when the operation finishes.
      */
     future<> load_new_sstables(sstring ks_name, sstring cf_name,
-            bool load_and_stream, bool primary_replica_only);
+            bool load_and_stream, bool primary_replica_only, bool load_and_distribute = false);
     future<> load_and_stream(sstring ks_name, sstring cf_name,
             utils::UUID table_id, std::vector<sstables::shared_sstable> sstables,
             bool primary_replica_only);
@@ -335,6 +335,149 @@ struct compaction_read_monitor_generator final : public read_monitor_generator {
      std::deque<compaction_read_monitor> _generated_monitors;
 };
 
+// Partition tombstones of the partitions being merged by a compaction, shared by
+// the readers of all its input sstables.
+//
+// The merging reader obtains the partition_start of every input positioned at a
+// partition before it asks any of them for the rest of that partition. So when an
+// input is asked for the rows of a partition, the partition tombstones of all the
+// other inputs having it are already known. If one of them is newer than all the
+// data of the input, the input has nothing left to contribute to that partition.
+class shadowing_tombstone_tracker {
+    const schema& _schema;
+    // No input is more than one partition ahead of the merge,
+    // so there's at most one entry per input.
+    std::vector<std::pair<dht::decorated_key, tombstone>> _tombstones;
+    uint64_t _skipped_partitions = 0;
+public:
+    explicit shadowing_tombstone_tracker(const schema& s)
+        : _schema(s) {
+    }
+
+    void on_partition_start(const dht::decorated_key& dk, tombstone t) {
+        if (!t) {
+            return;
+        }
+        for (auto& [key, tomb] : _tombstones) {
+            if (key.equal(_schema, dk)) {
+                tomb.apply(t);
+                return;
+            }
+        }
+        _tombstones.emplace_back(dk, t);
+    }
+
+    // Returns the highest partition tombstone seen so far for the given partition.
+    // Partitions are merged in order, so the ones before it are forgotten.
+    tombstone get(const dht::decorated_key& dk) {
+        tombstone ret;
+        std::erase_if(_tombstones, [&] (const std::pair<dht::decorated_key, tombstone>& e) {
+            auto c = e.first.tri_compare(_schema, dk);
+            if (c == 0) {
+                ret = e.second;
+            }
+            return c < 0;
+        });
+        return ret;
+    }
+
+    void on_partition_skipped() {
+        ++_skipped_partitions;
+    }
+
+    uint64_t skipped_partitions() const {
+        return _skipped_partitions;
+    }
+};
+
+// Reads a compaction input sstable, skipping the partitions in which all of its
+// data is shadowed by the partition tombstone of another input.
+//
+// A partition_start is always emitted on its own, so that the merging reader
+// learns the partition tombstones of the other inputs before it asks for more.
+// The rest of a shadowed partition is then skipped with next_partition(), which
+// uses the index of the sstable to jump over it, instead of being read and
+// decoded only for the compactor to drop it.
+class shadowed_partition_skipping_reader : public flat_mutation_reader::impl {
+    flat_mutation_reader _rd;
+    lw_shared_ptr<shadowing_tombstone_tracker> _tracker;
+    // Data is shadowed by a partition tombstone only if it's strictly newer, so
+    // that a tombstone with the same timestamp but a later deletion time, which
+    // would win the merge, isn't dropped.
+    api::timestamp_type _max_timestamp;
+    // Partition which was just started, and isn't known yet not to be shadowed.
+    std::optional<dht::decorated_key> _unchecked_partition;
+private:
+    future<stop_iteration> check_partition() {
+        auto tomb = _tracker->get(*_unchecked_partition);
+        _unchecked_partition.reset();
+        if (tomb.timestamp <= _max_timestamp) {
+            return make_ready_future<stop_iteration>(stop_iteration::no);
+        }
+        _tracker->on_partition_skipped();
+        push_mutation_fragment(*_schema, _permit, partition_end());
+        return _rd.next_partition().then([] {
+            return stop_iteration::no;
+        });
+    }
+public:
+    shadowed_partition_skipping_reader(flat_mutation_reader rd, lw_shared_ptr<shadowing_tombstone_tracker> tracker, api::timestamp_type max_timestamp)
+        : impl(rd.schema(), rd.permit())
+        , _rd(std::move(rd))
+        , _tracker(std::move(tracker))
+        , _max_timestamp(max_timestamp) {
+    }
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        return repeat([this, timeout] {
+            if (is_buffer_full() || is_end_of_stream()) {
+                return make_ready_future<stop_iteration>(stop_iteration::yes);
+            }
+            if (_unchecked_partition) {
+                return check_partition();
+            }
+            if (_rd.is_buffer_empty()) {
+                if (_rd.is_end_of_stream()) {
+                    _end_of_stream = true;
+                    return make_ready_future<stop_iteration>(stop_iteration::yes);
+                }
+                return _rd.fill_buffer(timeout).then([] {
+                    return stop_iteration::no;
+                });
+            }
+            auto mf = _rd.pop_mutation_fragment();
+            if (!mf.is_partition_start()) {
+                push_mutation_fragment(std::move(mf));
+                return make_ready_future<stop_iteration>(stop_iteration::no);
+            }
+            auto& ps = mf.as_partition_start();
+            _tracker->on_partition_start(ps.key(), ps.partition_tombstone());
+            _unchecked_partition = ps.key();
+            push_mutation_fragment(std::move(mf));
+            return make_ready_future<stop_iteration>(stop_iteration::yes);
+        });
+    }
+    virtual future<> next_partition() override {
+        clear_buffer_to_next_partition();
+        if (is_buffer_empty()) {
+            _end_of_stream = false;
+            _unchecked_partition.reset();
+            return _rd.next_partition();
+        }
+        return make_ready_future<>();
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        clear_buffer();
+        _end_of_stream = false;
+        _unchecked_partition.reset();
+        return _rd.fast_forward_to(pr, timeout);
+    }
+    virtual future<> fast_forward_to(position_range pr, db::timeout_clock::time_point timeout) override {
+        forward_buffer_to(pr.start());
+        _end_of_stream = false;
+        return _rd.fast_forward_to(std::move(pr), timeout);
+    }
+};
+
 // Writes a temporary sstable run containing only garbage collected data.
 // Whenever regular compaction writer seals a new sstable, this writer will flush a new sstable as well,
 // right before there's an attempt to release exhausted sstables earlier.
@@ -448,6 +591,8 @@ class compaction {
     // used to incrementally calculate max purgeable timestamp, as we iterate through decorated keys.
     std::optional<sstable_set::incremental_selector> _selector;
     std::unordered_set<shared_sstable> _compacting_for_max_purgeable_func;
+    // Set if more than one input sstable is actually read.
+    lw_shared_ptr<shadowing_tombstone_tracker> _shadowing_tracker;
 protected:
     compaction(column_family& cf, compaction_descriptor descriptor)
         : _cf(cf)
@@ -532,6 +677,18 @@ class compaction {
         return compaction_completion_desc{std::move(input_sstables), std::move(output_sstables)};
     }
 
+    // Wraps the readers of the input sstables to skip the partitions of an input
+    // which are wholly shadowed by a partition tombstone of another input.
+    sstable_reader_wrapper make_shadowed_partition_skipping_wrapper() const {
+        if (!_shadowing_tracker) {
+            return {};
+        }
+        return [tracker = _shadowing_tracker] (const shared_sstable& sst, flat_mutation_reader rd) {
+            return make_flat_mutation_reader<shadowed_partition_skipping_reader>(std::move(rd), tracker,
+                    sst->get_stats_metadata().max_timestamp);
+        };
+    }
+
     // Tombstone expiration is enabled based on the presence of sstable set.
     // If it's not present, we cannot purge tombstones without the risk of resurrecting data.
     bool tombstone_expiration_enabled() const {
@@ -559,6 +716,7 @@ class compaction {
         auto ssts = make_lw_shared<sstables::sstable_set>(_cf.get_compaction_strategy().make_sstable_set(_schema));
         sstring formatted_msg = "{} [";
         auto fully_expired = get_fully_expired_sstables(_cf, _sstables, gc_clock::now() - _schema->gc_grace_seconds());
+        auto copied_through = get_sstables_to_copy_through();
         min_max_tracker<api::timestamp_type> timestamp_tracker;
 
         for (auto& sst : _sstables) {
@@ -579,6 +737,12 @@ class compaction {
                 continue;
             }
 
+            // Reuse a sstable which has nothing to merge, purge or expire, instead of rewriting it.
+            if (copied_through.contains(sst)) {
+                copy_through(sst);
+                continue;
+            }
+
             // We also capture the sstable, so we keep it alive while the read isn't done
             ssts->insert(sst);
             // FIXME: If the sstables have cardinality estimation bitmaps, use that
@@ -599,12 +763,19 @@ class compaction {
         _info->ks_name = _schema->ks_name();
         _info->cf_name = _schema->cf_name();
         log_info(formatted_msg, report_start_desc());
-        if (ssts->all()->size() < _sstables.size()) {
+        if (ssts->all()->size() + copied_through.size() < _sstables.size()) {
             log_debug("{} out of {} input sstables are fully expired sstables that will not be actually compacted",
-                      _sstables.size() - ssts->all()->size(), _sstables.size());
+                      _sstables.size() - ssts->all()->size() - copied_through.size(), _sstables.size());
+        }
+        if (!copied_through.empty()) {
+            log_debug("{} out of {} input sstables don't overlap the rest of the input and were copied through",
+                      copied_through.size(), _sstables.size());
         }
 
         _compacting = std::move(ssts);
+        if (_compacting->all()->size() > 1) {
+            _shadowing_tracker = make_lw_shared<shadowing_tombstone_tracker>(*_schema);
+        }
 
         _ms_metadata.min_timestamp = timestamp_tracker.min();
         _ms_metadata.max_timestamp = timestamp_tracker.max();
@@ -612,13 +783,15 @@ class compaction {
         auto consumer = make_interposer_consumer([this, gc_consumer = std::move(gc_consumer), now] (flat_mutation_reader reader) mutable
         {
             using compact_mutations = compact_for_compaction<compacting_sstable_writer, GCConsumer>;
-            auto cfc = make_stable_flattened_mutations_consumer<compact_mutations>(*schema(), now,
-                                         max_purgeable_func(),
+            auto state = make_lw_shared<compact_mutation_state<emit_only_live_rows::no, compact_for_sstables::yes>>(*schema(), now,
+                                         max_purgeable_func());
+            auto cfc = make_stable_flattened_mutations_consumer<compact_mutations>(state,
                                          get_compacting_sstable_writer(),
                                          std::move(gc_consumer));
 
-            return seastar::async([cfc = std::move(cfc), reader = std::move(reader), this] () mutable {
+            return seastar::async([cfc = std::move(cfc), reader = std::move(reader), state = std::move(state), this] () mutable {
                 reader.consume_in_thread(std::move(cfc), db::no_timeout);
+                _info->tombstones_purged += state->purged_tombstones();
             });
         });
         return consumer(make_sstable_reader());
@@ -656,7 +829,15 @@ class compaction {
                 std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), pretty_printed_throughput(_info->end_size, duration),
                 _info->total_partitions, _info->total_keys_written);
 
+        if (_shadowing_tracker && _shadowing_tracker->skipped_partitions()) {
+            _info->shadowed_partitions_skipped = _shadowing_tracker->skipped_partitions();
+            log_debug("Skipped {} input partitions shadowed by a partition tombstone of another input sstable",
+                    _info->shadowed_partitions_skipped);
+        }
+
         backlog_tracker_adjust_charges();
+        _cf.get_compaction_manager().on_tombstones_purged(_info->tombstones_purged);
+        _cf.get_compaction_manager().on_shadowed_partitions_skipped(_info->shadowed_partitions_skipped);
 
         auto info = std::move(_info);
         _cf.get_compaction_manager().deregister_compaction(info);
@@ -685,6 +866,14 @@ class compaction {
     // Inform about every expired sstable that was skipped during setup phase
     virtual void on_skipped_expired_sstable(shared_sstable sstable) {}
 
+    // Returns the input sstables which can be moved to the output as they are.
+    virtual std::unordered_set<shared_sstable> get_sstables_to_copy_through() const {
+        return {};
+    }
+
+    // Makes an input sstable, returned by get_sstables_to_copy_through(), part of the output.
+    virtual void copy_through(shared_sstable sstable) {}
+
     // create a writer based on decorated key.
     virtual compaction_writer create_compaction_writer(const dht::decorated_key& dk) = 0;
     // stop current writer
@@ -834,7 +1023,8 @@ class reshape_compaction : public compaction {
                 tracing::trace_state_ptr(),
                 ::streamed_mutation::forwarding::no,
                 ::mutation_reader::forwarding::no,
-                default_read_monitor_generator());
+                default_read_monitor_generator(),
+                make_shadowed_partition_skipping_wrapper());
     }
 
     std::string_view report_start_desc() const override {
@@ -880,7 +1070,8 @@ class regular_compaction : public compaction {
                 tracing::trace_state_ptr(),
                 ::streamed_mutation::forwarding::no,
                 ::mutation_reader::forwarding::no,
-                _monitor_generator);
+                _monitor_generator,
+                make_shadowed_partition_skipping_wrapper());
     }
 
     std::string_view report_start_desc() const override {
@@ -934,6 +1125,57 @@ class regular_compaction : public compaction {
         // this will allow expired sstable to be removed from tracker once compaction completes
         _monitor_generator(std::move(sstable));
     }
+
+    // An input sstable can be copied through when merging it with the rest of
+    // the input would only rewrite its content, i.e. when it doesn't overlap
+    // any other input sstable and has no tombstone or expiring data which
+    // compaction could purge or convert. The sstable is then hard-linked into
+    // the output, instead of being decoded and encoded again.
+    //
+    // That's only done for compactions which move their input to another
+    // level, like a LCS promotion, where a reused sstable counts as progress.
+    // Other strategies would select the very same sstables again.
+    virtual std::unordered_set<shared_sstable> get_sstables_to_copy_through() const override {
+        std::unordered_set<shared_sstable> ret;
+        if (_info->type != compaction_type::Compaction) {
+            return ret;
+        }
+        auto format = _cf.get_sstables_manager().get_highest_supported_format();
+        if (format < sstable_version_types::mc) {
+            return ret;
+        }
+        auto now = gc_clock::now().time_since_epoch().count();
+        auto overlaps = [this] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_first_decorated_key().tri_compare(*_schema, b->get_last_decorated_key()) <= 0
+                && b->get_first_decorated_key().tri_compare(*_schema, a->get_last_decorated_key()) <= 0;
+        };
+        for (auto& sst : _sstables) {
+            auto& stats = sst->get_stats_metadata();
+            if (sst->get_sstable_level() == _sstable_level || sst->get_version() != format || sst->is_shared()
+                    || sst->data_size() > _max_sstable_size || stats.min_local_deletion_time <= now) {
+                continue;
+            }
+            if (std::none_of(_sstables.begin(), _sstables.end(), [&] (const shared_sstable& other) {
+                return other != sst && overlaps(sst, other);
+            })) {
+                ret.insert(sst);
+            }
+        }
+        return ret;
+    }
+
+    virtual void copy_through(shared_sstable sstable) override {
+        auto sst = _sstable_creator(this_shard_id());
+        sstable->create_links(sst->get_dir(), sst->generation()).get();
+        sst->load(_io_priority).get();
+        _info->new_sstables.push_back(sst);
+        _new_unused_sstables.push_back(sst);
+        _unused_sstables.push_back(sst);
+        sst->mutate_sstable_level(_sstable_level).get();
+        _info->end_size += sst->bytes_on_disk();
+        // The input is removed from the backlog tracker on completion, like the compacted input.
+        _monitor_generator(std::move(sstable));
+    }
 private:
     void backlog_tracker_incrementally_adjust_charges(std::vector<shared_sstable> exhausted_sstables) {
         //
@@ -83,6 +83,9 @@ namespace sstables {
         uint64_t end_size = 0;
         uint64_t total_partitions = 0;
         uint64_t total_keys_written = 0;
+        uint64_t tombstones_purged = 0;
+        // Input partitions skipped because a partition tombstone of another input shadowed all their data.
+        uint64_t shadowed_partitions_skipped = 0;
         int64_t ended_at;
         std::vector<shared_sstable> new_sstables;
         sstring stop_requested;
@@ -29,6 +29,7 @@
 #include <seastar/core/metrics.hh>
 #include "exceptions.hh"
 #include <cmath>
+#include <boost/range/adaptor/map.hpp>
 
 static logging::logger cmlog("compaction_manager");
 using namespace std::chrono_literals;
@@ -181,7 +182,7 @@ std::vector<sstables::shared_sstable> compaction_manager::get_candidates(const c
     auto& cs = cf.get_compaction_strategy();
 
     // Filter out sstables that are being compacted.
-    for (auto& sst : cf.non_staging_sstables()) {
+    for (auto& sst : cf.in_strategy_sstables()) {
         if (_compacting_sstables.contains(sst)) {
             continue;
         }
@@ -283,6 +284,12 @@ future<> compaction_manager::submit_major_compaction(column_family* cf) {
     return task->compaction_done.get_future().then([task] {});
 }
 
+future<> compaction_manager::perform_offstrategy(column_family* cf) {
+    return run_custom_job(cf, "offstrategy", [cf] {
+        return cf->run_offstrategy_compaction();
+    });
+}
+
 future<> compaction_manager::run_custom_job(column_family* cf, sstring name, noncopyable_function<future<>()> job) {
     if (_state != state::enabled) {
         return make_ready_future<>();
@@ -389,6 +396,16 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the number of compaction tasks waiting for an opportunity to run.")),
         sm::make_gauge("backlog", [this] { return _last_backlog; },
                        sm::description("Holds the sum of compaction backlog for all tables in the system.")),
+        sm::make_derive("tombstones_purged", [this] { return _stats.tombstones_purged; },
+                       sm::description("Holds the number of partition, row and range tombstones purged by compaction.")),
+        sm::make_derive("shadowed_partitions_skipped", [this] { return _stats.shadowed_partitions_skipped; },
+                       sm::description("Holds the number of input partitions which compaction skipped without reading, because a partition tombstone of another input shadowed all their data.")),
+        sm::make_gauge("controller_shares", [this] { return _compaction_controller.shares(); },
+                       sm::description("Holds the CPU and I/O shares currently given to compaction by its controller.")),
+        sm::make_gauge("controller_latency_factor", [this] { return _compaction_controller.latency_factor(); },
+                       sm::description("Holds the factor by which the controller scales down the shares derived from the backlog to meet the foreground latency goals.")),
+        sm::make_gauge("controller_latency_pressure", [this] { return _compaction_controller.latency_pressure(); },
+                       sm::description("Holds the highest ratio of observed to target foreground latency seen by the controller in its last interval.")),
     });
 }
 
@@ -396,6 +413,7 @@ void compaction_manager::enable() {
     assert(_state == state::none || _state == state::disabled);
     _state = state::enabled;
     _compaction_submission_timer.arm(periodic_compaction_submission_interval());
+    _garbage_collection_timer.arm_periodic(periodic_garbage_collection_interval());
     postponed_compactions_reevaluation();
 }
 
@@ -403,6 +421,7 @@ void compaction_manager::disable() {
     assert(_state == state::none || _state == state::enabled);
     _state = state::disabled;
     _compaction_submission_timer.cancel();
+    _garbage_collection_timer.cancel();
 }
 
 std::function<void()> compaction_manager::compaction_submission_callback() {
@@ -413,6 +432,27 @@ std::function<void()> compaction_manager::compaction_submission_callback() {
     };
 }
 
+std::function<void()> compaction_manager::garbage_collection_callback() {
+    return [this] () mutable {
+        // Previous round is still running.
+        if (!_garbage_collection.available()) {
+            return;
+        }
+        auto cfs = boost::copy_range<std::vector<column_family*>>(_compaction_locks | boost::adaptors::map_keys);
+        _garbage_collection = do_with(std::move(cfs), [this] (std::vector<column_family*>& cfs) {
+            return do_for_each(cfs, [this] (column_family* cf) {
+                // Column family may have been removed in the meantime.
+                if (_state != state::enabled || !_compaction_locks.contains(cf)) {
+                    return make_ready_future<>();
+                }
+                return perform_garbage_collection(cf).handle_exception([s = cf->schema()] (std::exception_ptr ep) {
+                    cmlog.warn("Garbage collection of {}.{} failed: {}", s->ks_name(), s->cf_name(), ep);
+                });
+            });
+        });
+    };
+}
+
 void compaction_manager::postponed_compactions_reevaluation() {
     _waiting_reevalution = repeat([this] {
         return _postponed_reevaluation.wait().then([this] {
@@ -483,9 +523,12 @@ void compaction_manager::really_do_stop() {
     cmlog.info("Asked to stop");
     // Reset the metrics registry
     _metrics.clear();
+    _garbage_collection_timer.cancel();
     _stop_future.emplace(stop_ongoing_compactions("shutdown").then([this] () mutable {
         reevaluate_postponed_compactions();
         return std::move(_waiting_reevalution);
+    }).then([this] {
+        return std::move(_garbage_collection);
     }).then([this] {
         _weight_tracker.clear();
         _compaction_submission_timer.cancel();
@@ -788,6 +831,33 @@ future<> compaction_manager::perform_sstable_scrub(column_family* cf, bool skip_
     });
 }
 
+future<> compaction_manager::perform_garbage_collection(column_family* cf) {
+    auto schema = cf->schema();
+    auto gc_before = gc_clock::now() - schema->gc_grace_seconds();
+    auto candidates = get_candidates(*cf);
+    auto expired = sstables::get_fully_expired_sstables(*cf, candidates, gc_before);
+    auto& cs = cf->get_compaction_strategy();
+
+    // Fully expired sstables are rewritten into nothing, without being read.
+    // Others are rewritten alone, which purges their expired data as long as
+    // it doesn't shadow data of overlapping sstables, just like regular
+    // compaction would.
+    std::vector<sstables::shared_sstable> sstables;
+    for (auto& sst : candidates) {
+        if (expired.contains(sst) || cs.worth_dropping_tombstones(sst, gc_before)) {
+            sstables.push_back(sst);
+        }
+    }
+    if (sstables.empty()) {
+        return make_ready_future<>();
+    }
+    cmlog.info("Garbage collecting {}.{}: {} fully expired sstables, {} sstables with droppable tombstones",
+            schema->ks_name(), schema->cf_name(), expired.size(), sstables.size() - expired.size());
+    return rewrite_sstables(cf, sstables::compaction_options::make_regular(), [sstables = std::move(sstables)] (const table&) mutable {
+        return std::move(sstables);
+    });
+}
+
 future<> compaction_manager::remove(column_family* cf) {
     // FIXME: better way to iterate through compaction info for a given column family,
     // although this path isn't performance sensitive.
@@ -56,6 +56,8 @@ class compaction_manager {
         int64_t completed_tasks = 0;
         uint64_t active_tasks = 0; // Number of compaction going on.
         int64_t errors = 0;
+        uint64_t tombstones_purged = 0;
+        uint64_t shadowed_partitions_skipped = 0;
     };
 private:
     struct task {
@@ -118,6 +120,13 @@ class compaction_manager {
     // Submission is a NO-OP when there's nothing to do, so it's fine to call it regularly.
     timer<lowres_clock> _compaction_submission_timer = timer<lowres_clock>(compaction_submission_callback());
     static constexpr std::chrono::seconds periodic_compaction_submission_interval() { return std::chrono::seconds(3600); }
+
+    std::function<void()> garbage_collection_callback();
+    // All registered column families are garbage collected, one at a time, at a constant interval.
+    // Sstables are only picked based on their metadata, so it's cheap when there's nothing to collect.
+    future<> _garbage_collection = make_ready_future<>();
+    timer<lowres_clock> _garbage_collection_timer = timer<lowres_clock>(garbage_collection_callback());
+    static constexpr std::chrono::seconds periodic_garbage_collection_interval() { return std::chrono::hours(6); }
 private:
     future<> task_stop(lw_shared_ptr<task> task);
 
@@ -211,6 +220,16 @@ class compaction_manager {
     // Submit a column family for major compaction.
     future<> submit_major_compaction(column_family* cf);
 
+    // Submit a column family for garbage collection and wait for its termination.
+    // Garbage collection drops the fully expired sstables of a column family, and
+    // rewrites alone each of its sstables whose estimated ratio of droppable
+    // tombstones is above the tombstone threshold of its compaction strategy,
+    // purging their expired data without rewriting other sstables.
+    future<> perform_garbage_collection(column_family* cf);
+
+    // Reshape the sstables added off-strategy to a column family by repair
+    // or streaming, and integrate the result into its main sstable set.
+    future<> perform_offstrategy(column_family* cf);
 
     // Run a custom job for a given column family, defined by a function
     // it completes when future returned by job is ready or returns immediately
@@ -239,6 +258,14 @@ class compaction_manager {
         _compactions.remove(c);
     }
 
+    void on_tombstones_purged(uint64_t count) {
+        _stats.tombstones_purged += count;
+    }
+
+    void on_shadowed_partitions_skipped(uint64_t count) {
+        _stats.shadowed_partitions_skipped += count;
+    }
+
     const std::list<lw_shared_ptr<sstables::compaction_info>>& get_compactions() const {
         return _compactions;
     }
@@ -262,6 +289,11 @@ class compaction_manager {
         return _backlog_manager.backlog();
     }
 
+    // Trades compaction shares for foreground latency, see compaction_controller.
+    void set_latency_goals(std::vector<compaction_controller::latency_goal> goals) {
+        _compaction_controller.set_latency_goals(std::move(goals));
+    }
+
     void register_backlog_tracker(compaction_backlog_tracker& backlog_tracker) {
         _backlog_manager.register_backlog_tracker(backlog_tracker);
     }
@@ -48,12 +48,15 @@
 #include "schema.hh"
 #include "sstable_set.hh"
 #include <boost/range/algorithm/find.hpp>
+#include <boost/range/algorithm/sort.hpp>
 #include <boost/range/adaptors.hpp>
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include "size_tiered_compaction_strategy.hh"
 #include "date_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
+#include "unified_compaction_strategy.hh"
 #include "sstables/compaction_backlog_manager.hh"
 #include "sstables/size_tiered_backlog_tracker.hh"
 
@@ -80,6 +83,37 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
 }
 
+compaction_descriptor compaction_strategy_impl::make_tombstone_compaction_job(column_family& cf, const shared_sstable& sst,
+        const std::vector<shared_sstable>& candidates) const {
+    auto max_timestamp = sst->get_stats_metadata().max_timestamp;
+    auto overlapping = leveled_manifest::overlapping(*cf.schema(), sst, candidates);
+    auto e = boost::range::remove_if(overlapping, [&] (const shared_sstable& other) {
+        return other == sst || other->get_stats_metadata().min_timestamp > max_timestamp;
+    });
+    overlapping.erase(e, overlapping.end());
+    boost::sort(overlapping, [] (const shared_sstable& a, const shared_sstable& b) {
+        return a->get_stats_metadata().min_timestamp < b->get_stats_metadata().min_timestamp;
+    });
+    auto max_overlapping = size_t(std::max(cf.schema()->max_compaction_threshold(), 2)) - 1;
+    auto max_overlapping_size = uint64_t(sst->data_size() * tombstone_compaction_max_expansion);
+
+    std::vector<shared_sstable> sstables;
+    sstables.reserve(std::min(overlapping.size(), max_overlapping) + 1);
+    sstables.push_back(sst);
+    uint64_t overlapping_size = 0;
+    for (auto& other : overlapping) {
+        if (sstables.size() > max_overlapping) {
+            break;
+        }
+        if (overlapping_size + other->data_size() > max_overlapping_size) {
+            continue;
+        }
+        overlapping_size += other->data_size();
+        sstables.push_back(other);
+    }
+    return compaction_descriptor(std::move(sstables), cf.get_sstable_set(), service::get_local_compaction_priority());
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) {
     return partition_estimate;
 }
@@ -662,6 +696,10 @@ compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema
     return _compaction_strategy_impl->get_reshaping_job(std::move(input), schema, iop, mode);
 }
 
+bool compaction_strategy::worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before) {
+    return _compaction_strategy_impl->worth_dropping_tombstones(sst, gc_before);
+}
+
 uint64_t compaction_strategy::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) {
     return _compaction_strategy_impl->adjust_partition_estimate(ms_meta, partition_estimate);
 }
@@ -693,6 +731,12 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
+    case compaction_strategy_type::unified:
+        impl = ::make_shared<unified_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
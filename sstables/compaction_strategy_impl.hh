@@ -39,6 +39,10 @@ class compaction_strategy_impl {
     static constexpr float DEFAULT_TOMBSTONE_THRESHOLD = 0.2f;
     // minimum interval needed to perform tombstone removal compaction in seconds, default 86400 or 1 day.
     static constexpr std::chrono::seconds DEFAULT_TOMBSTONE_COMPACTION_INTERVAL() { return std::chrono::seconds(86400); }
+public:
+    // Largest total size of the sstables added to a tombstone compaction, relative to
+    // the size of the sstable whose tombstones are to be dropped.
+    static constexpr double tombstone_compaction_max_expansion = 2.0;
 protected:
     const sstring TOMBSTONE_THRESHOLD_OPTION = "tombstone_threshold";
     const sstring TOMBSTONE_COMPACTION_INTERVAL_OPTION = "tombstone_compaction_interval";
@@ -76,6 +80,16 @@ class compaction_strategy_impl {
     // droppable tombstone histogram and gc_before.
     bool worth_dropping_tombstones(const shared_sstable& sst, gc_clock::time_point gc_before);
 
+    // Returns a compaction job for dropping the tombstones of a sstable which is worth it.
+    //
+    // Tombstones can only be purged once they don't shadow data in sstables which
+    // are not compacted along with them. So the job includes the candidates which
+    // overlap the sstable and are old enough to hold data shadowed by its tombstones,
+    // oldest first, up to the table's max_threshold, and as long as their total size
+    // stays within tombstone_compaction_max_expansion times the size of the sstable,
+    // so that the job doesn't turn into a major compaction.
+    compaction_descriptor make_tombstone_compaction_job(column_family& cf, const shared_sstable& sst, const std::vector<shared_sstable>& candidates) const;
+
     virtual compaction_backlog_tracker& get_backlog_tracker() = 0;
 
     virtual uint64_t adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate);
@@ -39,6 +39,7 @@ enum class component_type {
     TemporaryTOC,
     TemporaryStatistics,
     Scylla,
+    Partitions,
     Unknown,
 };
 
@@ -131,6 +131,15 @@ class primitive_consumer {
             _prestate = ReadingVint;
             return read_status::waiting;
         } else {
+            // A buffer holding at least max_vint_length bytes holds the whole vint,
+            // which can then be decoded without looking at its first byte twice.
+            if (__builtin_expect(data.size() >= max_vint_length, true)) {
+                const auto [value, size] = VintType::deserialize_with_size(
+                        bytes_view(reinterpret_cast<const bytes::value_type*>(data.get()), data.size()));
+                dest = value;
+                data.trim_front(size);
+                return read_status::ready;
+            }
             const vint_size_type len = VintType::serialized_size_from_first_byte(*data.begin());
             if (data.size() >= len) {
                 dest = VintType::deserialize(
@@ -246,6 +255,13 @@ class primitive_consumer {
             _read_bytes_where = &where;
             return read_status::waiting;
         } else {
+            if (__builtin_expect(data.size() >= max_vint_length, true)) {
+                const auto [value, size] = unsigned_vint::deserialize_with_size(
+                        bytes_view(reinterpret_cast<const bytes::value_type*>(data.get()), data.size()));
+                _u64 = value;
+                data.trim_front(size);
+                return read_bytes(data, static_cast<uint32_t>(_u64), where);
+            }
             const vint_size_type len = unsigned_vint::serialized_size_from_first_byte(*data.begin());
             if (data.size() >= len) {
                 _u64 = unsigned_vint::deserialize(
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "incremental_compaction_strategy.hh"
+#include "size_tiered_backlog_tracker.hh"
+#include "compaction.hh"
+#include "database.hh"
+#include "service/priority_manager.hh"
+
+#include <boost/algorithm/cxx11/none_of.hpp>
+#include <boost/range/adaptors.hpp>
+#include <boost/range/algorithm.hpp>
+
+namespace sstables {
+
+extern logging::logger clogger;
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+    // A run is tracked as if it were made of independent sstables, which
+    // slightly overestimates the backlog of tables with large runs.
+    , _backlog_tracker(std::make_unique<size_tiered_backlog_tracker>())
+{
+    using namespace cql3::statements;
+    auto fragment_size_in_mb = property_definitions::to_int(FRAGMENT_SIZE_OPTION,
+            compaction_strategy_impl::get_value(options, FRAGMENT_SIZE_OPTION), DEFAULT_FRAGMENT_SIZE_IN_MB);
+    if (fragment_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("{} must be greater than 0, but was {}", FRAGMENT_SIZE_OPTION, fragment_size_in_mb));
+    }
+    _fragment_size = uint64_t(fragment_size_in_mb) * 1024 * 1024;
+}
+
+std::vector<incremental_compaction_strategy::sized_run>
+incremental_compaction_strategy::make_runs(const std::vector<shared_sstable>& candidates) {
+    std::unordered_map<utils::UUID, sstable_run> runs;
+    for (auto& sst : candidates) {
+        runs[sst->run_identifier()].insert(sst);
+    }
+    std::vector<sized_run> ret;
+    ret.reserve(runs.size());
+    for (auto& [id, run] : runs) {
+        auto size = run.data_size();
+        ret.push_back(sized_run{std::move(run), size});
+    }
+    return ret;
+}
+
+std::vector<std::vector<incremental_compaction_strategy::sized_run>>
+incremental_compaction_strategy::get_buckets(std::vector<sized_run> runs) const {
+    std::sort(runs.begin(), runs.end(), [] (const sized_run& a, const sized_run& b) {
+        return a.size < b.size;
+    });
+
+    // See size_tiered_compaction_strategy::get_buckets().
+    std::map<uint64_t, std::vector<sized_run>> buckets;
+    for (auto& r : runs) {
+        auto size = r.size;
+        auto it = boost::find_if(buckets, [&] (const auto& e) {
+            auto old_average_size = e.first;
+            return (size > old_average_size * _options.bucket_low && size < old_average_size * _options.bucket_high)
+                    || (size < _options.min_sstable_size && old_average_size < _options.min_sstable_size);
+        });
+        if (it == buckets.end()) {
+            buckets[size].push_back(std::move(r));
+            continue;
+        }
+        auto bucket = std::move(it->second);
+        auto new_average_size = (bucket.size() * it->first + size) / (bucket.size() + 1);
+        bucket.push_back(std::move(r));
+        buckets.erase(it);
+        auto& dst = buckets[new_average_size];
+        std::move(bucket.begin(), bucket.end(), std::back_inserter(dst));
+    }
+
+    return boost::copy_range<std::vector<std::vector<sized_run>>>(buckets | boost::adaptors::map_values);
+}
+
+std::vector<incremental_compaction_strategy::sized_run>
+incremental_compaction_strategy::most_interesting_bucket(std::vector<std::vector<sized_run>> buckets, size_t min_threshold, size_t max_threshold) {
+    // Buckets are ordered by average run size, so the first interesting
+    // bucket is the one holding the smallest runs.
+    for (auto& bucket : buckets) {
+        if (bucket.size() >= min_threshold) {
+            bucket.resize(std::min(bucket.size(), max_threshold));
+            return std::move(bucket);
+        }
+    }
+    return {};
+}
+
+std::vector<shared_sstable> incremental_compaction_strategy::fragments_of(const std::vector<sized_run>& runs) {
+    std::vector<shared_sstable> ret;
+    for (auto& r : runs) {
+        ret.insert(ret.end(), r.run.all().begin(), r.run.all().end());
+    }
+    return ret;
+}
+
+compaction_descriptor incremental_compaction_strategy::make_descriptor(column_family& cf, std::vector<shared_sstable> sstables) const {
+    return compaction_descriptor(std::move(sstables), cf.get_sstable_set(), service::get_local_compaction_priority(),
+            compaction_descriptor::default_level, _fragment_size);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    size_t min_threshold = cf.min_compaction_threshold();
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    auto gc_before = gc_clock::now() - cf.schema()->gc_grace_seconds();
+
+    auto buckets = get_buckets(make_runs(candidates));
+
+    if (auto bucket = most_interesting_bucket(buckets, min_threshold, max_threshold); !bucket.empty()) {
+        return make_descriptor(cf, fragments_of(bucket));
+    }
+    if (!cf.compaction_enforce_min_threshold()) {
+        if (auto bucket = most_interesting_bucket(buckets, 2, max_threshold); !bucket.empty()) {
+            return make_descriptor(cf, fragments_of(bucket));
+        }
+    }
+
+    // Fall back to rewriting a single run whose fragments are worth dropping
+    // tombstones from, preferring the oldest run of the largest tier, like STCS.
+    for (auto&& bucket : buckets | boost::adaptors::reversed) {
+        auto e = boost::range::remove_if(bucket, [this, &gc_before] (const sized_run& r) {
+            return boost::algorithm::none_of(r.run.all(), [this, &gc_before] (const shared_sstable& sst) {
+                return worth_dropping_tombstones(sst, gc_before);
+            });
+        });
+        bucket.erase(e, bucket.end());
+        if (bucket.empty()) {
+            continue;
+        }
+        auto min_timestamp = [] (const sized_run& r) {
+            return boost::min_element(r.run.all() | boost::adaptors::transformed([] (const shared_sstable& sst) {
+                return sst->get_stats_metadata().min_timestamp;
+            })).base();
+        };
+        auto it = boost::min_element(bucket, [&] (const sized_run& a, const sized_run& b) {
+            return *min_timestamp(a) < *min_timestamp(b);
+        });
+        return make_descriptor(cf, fragments_of({*it}));
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    return make_descriptor(cf, std::move(candidates));
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(column_family& cf) const {
+    size_t min_threshold = cf.min_compaction_threshold();
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    std::vector<shared_sstable> sstables;
+    sstables.reserve(cf.sstables_count());
+    for (auto all_sstables = cf.get_sstables(); auto& entry : *all_sstables) {
+        sstables.push_back(entry);
+    }
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(make_runs(sstables))) {
+        if (bucket.size() >= min_threshold) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+    size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
+    size_t max_runs = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+
+    if (mode == reshape_mode::relaxed) {
+        offstrategy_threshold = max_runs;
+    }
+
+    auto bucket = most_interesting_bucket(get_buckets(make_runs(input)), offstrategy_threshold, max_runs);
+    if (bucket.empty()) {
+        return compaction_descriptor();
+    }
+    clogger.debug("Reshaping {} runs of {}.{} with incremental compaction strategy", bucket.size(), schema->ks_name(), schema->cf_name());
+    compaction_descriptor desc(fragments_of(bucket), std::optional<sstables::sstable_set>(), iop,
+            compaction_descriptor::default_level, _fragment_size);
+    desc.options = compaction_options::make_reshape();
+    return desc;
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstable_set.hh"
+
+namespace sstables {
+
+// Incremental compaction strategy (ICS) is size-tiered compaction applied to
+// sstable runs instead of individual sstables.
+//
+// Every compaction writes its output as a run of fixed-size fragments
+// (sstable_size_in_mb), and all fragments of a run are compacted together,
+// so a run behaves like a single, large, logical sstable for the purpose of
+// tiering. Because fragments of a run don't overlap, compaction releases an
+// input fragment as soon as all of its data is in sealed output fragments
+// (see garbage_collected_sstable_writer in compaction.cc). The temporary space
+// overhead of a compaction is therefore bounded by a few fragments per input
+// run, rather than by the size of the input as with STCS, which needs up to
+// twice the input size in free disk space.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+    static constexpr int32_t DEFAULT_FRAGMENT_SIZE_IN_MB = 1000;
+    const sstring FRAGMENT_SIZE_OPTION = "sstable_size_in_mb";
+
+    uint64_t _fragment_size;
+    size_tiered_compaction_strategy_options _options;
+    compaction_backlog_tracker _backlog_tracker;
+
+    struct sized_run {
+        sstable_run run;
+        uint64_t size;
+    };
+
+    static std::vector<sized_run> make_runs(const std::vector<shared_sstable>& candidates);
+
+    // Group runs of similar size into buckets, the way STCS groups sstables.
+    std::vector<std::vector<sized_run>> get_buckets(std::vector<sized_run> runs) const;
+
+    // Returns the bucket of smallest runs with at least min_threshold runs,
+    // trimmed to max_threshold runs, or an empty vector if there's none.
+    static std::vector<sized_run> most_interesting_bucket(std::vector<std::vector<sized_run>> buckets, size_t min_threshold, size_t max_threshold);
+
+    static std::vector<shared_sstable> fragments_of(const std::vector<sized_run>& runs);
+
+    compaction_descriptor make_descriptor(column_family& cf, std::vector<shared_sstable> sstables) const;
+public:
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    virtual compaction_descriptor get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(column_family& cf, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(column_family& cf) const override;
+
+    virtual compaction_strategy_type type() const {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+
+    uint64_t fragment_size() const {
+        return _fragment_size;
+    }
+};
+
+}
@@ -24,12 +24,15 @@
 #include "consumer.hh"
 #include "downsampling.hh"
 #include "sstables/shared_index_lists.hh"
+#include "sstables/partition_trie.hh"
 #include <seastar/util/bool_class.hh>
 #include "utils/buffer_input_stream.hh"
 #include "sstables/prepended_input_stream.hh"
 #include "tracing/traced_file.hh"
 #include "sstables/scanning_clustered_index_cursor.hh"
 #include "sstables/mx/bsearch_clustered_cursor.hh"
+#include "sstables/promoted_index_cache.hh"
+#include "sstables/sstables_manager.hh"
 
 namespace sstables {
 
@@ -301,9 +304,16 @@ std::unique_ptr<clustered_index_cursor> promoted_index::make_cursor(shared_sstab
 
         f.populate_front(_front.share());
 
+        lw_shared_ptr<mc::cached_promoted_index::block_set> blocks;
+        auto& pi_cache = sst->manager().get_promoted_index_cache();
+        if (pi_cache.enabled()) {
+            blocks = pi_cache.get(*sst, _promoted_index_start, *sst->get_schema(), promoted_index_cache_metrics);
+        }
+
         return std::make_unique<mc::bsearch_clustered_cursor>(*sst->get_schema(),
             promoted_index_cache_metrics, permit,
-            *ck_values_fixed_lengths, std::move(f), options.io_priority_class, _num_blocks, trace_state);
+            *ck_values_fixed_lengths, std::move(f), options.io_priority_class, _num_blocks, trace_state,
+            std::move(blocks));
     }
 
     input_stream<char> promoted_index_stream = [&] {
@@ -363,6 +373,10 @@ struct index_bound {
     uint64_t data_file_position = 0;
     indexable_element element = indexable_element::partition;
     std::optional<open_rt_marker> end_open_marker;
+    // Set when current_list was read through the partition trie, in which case
+    // it holds the entries of the partition found and of the next one only,
+    // and the summary indexes are not set.
+    bool partial_page = false;
 
     // Holds the cursor for the current partition. Lazily initialized.
     std::unique_ptr<clustered_index_cursor> clustered_cursor;
@@ -377,6 +391,7 @@ struct index_bound {
             , data_file_position(other.data_file_position)
             , element(other.element)
             , end_open_marker(other.end_open_marker)
+            , partial_page(other.partial_page)
     { }
 
     index_bound(index_bound&&) noexcept = default;
@@ -453,15 +468,37 @@ class index_reader {
         bound.data_file_position = data_file_end();
         bound.element = indexable_element::partition;
         bound.current_list = {};
+        bound.partial_page = false;
         bound.end_open_marker.reset();
         return reset_clustered_cursor(bound);
     }
 
+    // Reads the index entries in [begin, end) of the index file.
+    future<index_list> read_index_entries(uint64_t begin, uint64_t end, uint64_t quantity) {
+        return do_with(std::make_unique<reader>(_sstable, _permit, _pc, _trace_state, begin, end, quantity), [this] (auto& entries_reader) {
+            return entries_reader->_context.consume_input().then_wrapped([this, &entries_reader] (future<> f) {
+                std::exception_ptr ex;
+                if (f.failed()) {
+                    ex = f.get_exception();
+                    sstlog.error("failed reading index for {}: {}", _sstable->get_filename(), ex);
+                }
+                auto indexes = std::move(entries_reader->_consumer.indexes);
+                return entries_reader->_context.close().then([indexes = std::move(indexes), ex = std::move(ex)] () mutable {
+                    if (ex) {
+                        return make_exception_future<index_list>(std::move(ex));
+                    }
+                    return make_ready_future<index_list>(std::move(indexes));
+                });
+
+            });
+        });
+    }
+
     // Must be called for non-decreasing summary_idx.
     future<> advance_to_page(index_bound& bound, uint64_t summary_idx) {
         sstlog.trace("index {}: advance_to_page({}), bound {}", fmt::ptr(this), summary_idx, fmt::ptr(&bound));
-        assert(!bound.current_list || bound.current_summary_idx <= summary_idx);
-        if (bound.current_list && bound.current_summary_idx == summary_idx) {
+        assert(!bound.current_list || bound.partial_page || bound.current_summary_idx <= summary_idx);
+        if (bound.current_list && !bound.partial_page && bound.current_summary_idx == summary_idx) {
             sstlog.trace("index {}: same page", fmt::ptr(this));
             return make_ready_future<>();
         }
@@ -484,27 +521,12 @@ class index_reader {
                 end = summary.entries[summary_idx + 1].position;
             }
 
-            return do_with(std::make_unique<reader>(_sstable, _permit, _pc, _trace_state, position, end, quantity), [this, summary_idx] (auto& entries_reader) {
-                return entries_reader->_context.consume_input().then_wrapped([this, summary_idx, &entries_reader] (future<> f) {
-                    std::exception_ptr ex;
-                    if (f.failed()) {
-                        ex = f.get_exception();
-                        sstlog.error("failed reading index for {}: {}", _sstable->get_filename(), ex);
-                    }
-                    auto indexes = std::move(entries_reader->_consumer.indexes);
-                    return entries_reader->_context.close().then([indexes = std::move(indexes), ex = std::move(ex)] () mutable {
-                        if (ex) {
-                            return make_exception_future<index_list>(std::move(ex));
-                        }
-                        return make_ready_future<index_list>(std::move(indexes));
-                    });
-
-                });
-            });
+            return read_index_entries(position, end, quantity);
         };
 
         return _index_lists.get_or_load(summary_idx, loader).then([this, &bound, summary_idx] (shared_index_lists::list_ptr ref) {
             bound.current_list = std::move(ref);
+            bound.partial_page = false;
             bound.current_summary_idx = summary_idx;
             bound.current_index_idx = 0;
             bound.current_pi_idx = 0;
@@ -582,6 +604,14 @@ class index_reader {
             bound.end_open_marker.reset();
             return reset_clustered_cursor(bound);
         }
+        if (bound.partial_page) {
+            // Continue from the summary page of the next partition, which we
+            // find by its position, as the page of the current one isn't known.
+            auto e = current_partition_entry(bound).get_decorated_key();
+            return do_with(e.token(), e.key().to_partition_key(*_sstable->_schema), [this, &bound] (const dht::token& t, const partition_key& pk) {
+                return advance_to(bound, dht::ring_position_view(t, &pk, 1));
+            });
+        }
         auto& summary = _sstable->get_summary();
         if (bound.current_summary_idx + 1 < summary.header.size) {
             return advance_to_page(bound, bound.current_summary_idx + 1);
@@ -695,6 +725,41 @@ class index_reader {
         });
     }
 
+    bool can_use_partition_trie(const index_bound& bound, dht::ring_position_view key) const {
+        return _sstable->has_partition_trie() && key.key() && !key.is_after_key() && !bound.current_list;
+    }
+
+    // Positions the bound on the only partition which can have the given key,
+    // found through the partition trie. Resolves to false, leaving the bound
+    // untouched, if the trie tells that the sstable doesn't have the key.
+    future<bool> advance_to_partition_trie_candidate(index_bound& bound, dht::ring_position_view key) {
+        auto k = sstables::key::from_partition_key(*_sstable->_schema, *key.key());
+        auto payload = co_await _sstable->get_partition_trie().lookup(partition_trie_key(key.token(), bytes_view(k)), _pc);
+        if (!payload) {
+            co_return false;
+        }
+        // Pages read through the trie are cached apart from the summary pages,
+        // by their position in the index file.
+        auto page_key = (shared_index_lists::key_type(1) << 63) | payload->index_position;
+        auto list = co_await _index_lists.get_or_load(page_key, [this, &payload] (shared_index_lists::key_type) {
+            return read_index_entries(payload->index_position, payload->index_position + payload->index_length, 2);
+        });
+        if (list->empty()) {
+            throw malformed_sstable_exception("missing index entry", _sstable->filename(component_type::Index));
+        }
+        bound.current_list = std::move(list);
+        bound.partial_page = true;
+        bound.previous_summary_idx = 0;
+        bound.current_summary_idx = 0;
+        bound.current_index_idx = 0;
+        bound.current_pi_idx = 0;
+        bound.data_file_position = (*bound.current_list)[0].position();
+        bound.element = indexable_element::partition;
+        bound.end_open_marker.reset();
+        co_await reset_clustered_cursor(bound);
+        co_return true;
+    }
+
     // Returns position right after all partitions in the sstable
     uint64_t data_file_end() const {
         return _sstable->data_size();
@@ -836,8 +901,11 @@ class index_reader {
     // If upper_bound is provided, the upper bound within position is looked up
     future<bool> advance_lower_and_check_if_present(
             dht::ring_position_view key, std::optional<position_in_partition_view> pos = {}) {
-        return advance_to(_lower_bound, key).then([this, key, pos] {
-            if (eof()) {
+        auto advanced = can_use_partition_trie(_lower_bound, key)
+                ? advance_to_partition_trie_candidate(_lower_bound, key)
+                : advance_to(_lower_bound, key).then([] { return true; });
+        return advanced.then([this, key, pos] (bool candidate) {
+            if (!candidate || eof()) {
                 return make_ready_future<bool>(false);
             }
             return read_partition_data().then([this, key, pos] {
@@ -409,10 +409,7 @@ file_writer sstable_writer_k_l::index_file_writer(sstable& sst, const io_priorit
 
 void sstable_writer_k_l::prepare_file_writer()
 {
-    file_output_stream_options options;
-    options.io_priority_class = _pc;
-    options.buffer_size = _sst.sstable_buffer_size;
-    options.write_behind = 10;
+    auto options = make_data_write_options(_sst._data_file, _cfg.data_write_buffer_size, _cfg.data_write_in_flight_size, _pc);
 
     if (!_compression_enabled) {
         auto out = make_file_data_sink(std::move(_sst._data_file), options).get0();
@@ -29,6 +29,7 @@
 
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/on_internal_error.hh>
+#include <seastar/core/shared_ptr.hh>
 
 #include <optional>
 
@@ -146,6 +147,50 @@ class cached_promoted_index {
             return lhs < rhs.index;
         }
     };
+
+    // The parsed blocks of a promoted index. Owned by a single cached_promoted_index,
+    // or shared through the promoted_index_cache by the cursors into the same partition.
+    class block_set {
+    public:
+        using set_type = std::set<promoted_index_block, block_comparator>;
+    private:
+        set_type _set;
+        metrics& _metrics;
+        uint64_t _used_bytes = 0;
+        // Memory used by all shared block sets, when shared.
+        uint64_t* _shared_used_bytes;
+        // Memory past which a shared set takes no more blocks.
+        uint64_t _max_bytes;
+    public:
+        block_set(const schema& s, metrics& m, uint64_t* shared_used_bytes = nullptr, uint64_t max_bytes = 0)
+            : _set(block_comparator{s})
+            , _metrics(m)
+            , _shared_used_bytes(shared_used_bytes)
+            , _max_bytes(max_bytes)
+        { }
+
+        block_set(const block_set&) = delete;
+        block_set(block_set&&) = delete;
+
+        ~block_set() {
+            _metrics.block_count -= _set.size();
+            _metrics.evictions += _set.size();
+            account(-int64_t(_used_bytes));
+        }
+
+        set_type& set() { return _set; }
+        bool shared() const { return _shared_used_bytes; }
+        bool full() const { return _max_bytes && _used_bytes >= _max_bytes; }
+        uint64_t used_bytes() const { return _used_bytes; }
+
+        void account(int64_t delta) {
+            _metrics.used_bytes += delta;
+            _used_bytes += delta;
+            if (_shared_used_bytes) {
+                *_shared_used_bytes += delta;
+            }
+        }
+    };
 private:
     // Cache of the parsed promoted index blocks.
     //
@@ -159,8 +204,15 @@ class cached_promoted_index {
     // savings in CPU time from less over-reads more than compensate
     // for it.
     //
-    using block_set_type = std::set<promoted_index_block, block_comparator>;
-    block_set_type _blocks;
+    // Blocks of a shared set stay until the whole set is evicted from the
+    // promoted_index_cache, so that other reads into the partition reuse them.
+    // Once a shared set is full, the cursor missing a block in it continues
+    // with a private set of its own, from which invalidate_prior() evicts.
+    using block_set_type = block_set::set_type;
+    lw_shared_ptr<block_set> _blocks;
+    // In a shared set, a missing block is parsed here before it is inserted,
+    // since the other cursors may look blocks up by their start position.
+    std::optional<promoted_index_block> _pending;
 public:
     const schema& _s;
     metrics& _metrics;
@@ -213,7 +265,7 @@ class cached_promoted_index {
         return consume_stream(_stream, _clustering_parser).then([this, &block] {
             auto mem_before = block.memory_usage();
             block.start.emplace(_clustering_parser.get_and_reset());
-            _metrics.used_bytes += block.memory_usage() - mem_before;
+            account_block_change(block, mem_before);
         });
     }
 
@@ -229,33 +281,78 @@ class cached_promoted_index {
             block.end_open_marker = _block_parser.end_open_marker();
             block.data_file_offset = _block_parser.offset();
             block.width = _block_parser.width();
-            _metrics.used_bytes += block.memory_usage() - mem_before;
+            account_block_change(block, mem_before);
         });
     }
 
+    bool is_pending(const promoted_index_block& block) const {
+        return _pending && &*_pending == &block;
+    }
+
+    void account_block_change(const promoted_index_block& block, size_t mem_before) {
+        // A pending block is accounted for once it is inserted.
+        if (!is_pending(block)) {
+            _blocks->account(int64_t(block.memory_usage()) - int64_t(mem_before));
+        }
+    }
+
     /// \brief Returns a pointer to promoted_index_block entry which has at least offset and index fields valid.
+    ///
+    /// The block may be pending, in which case it must be passed to publish() once its start is valid.
     future<promoted_index_block*> get_block_only_offset(pi_index_type idx, tracing::trace_state_ptr trace_state) {
-        auto i = _blocks.lower_bound(idx);
-        if (i != _blocks.end() && i->index == idx) {
+        auto i = _blocks->set().lower_bound(idx);
+        if (i != _blocks->set().end() && i->index == idx) {
             ++_metrics.hits_l0;
             return make_ready_future<promoted_index_block*>(const_cast<promoted_index_block*>(&*i));
         }
         ++_metrics.misses_l0;
+        if (_blocks->shared() && _blocks->full()) {
+            // No pointers into the shared set are held between calls, so it can be let go.
+            _blocks = make_lw_shared<block_set>(_s, _metrics);
+            i = _blocks->set().end();
+        }
         return read_block_offset(idx, trace_state).then([this, idx, hint = i] (pi_offset_type offset) {
-            auto i = this->_blocks.emplace_hint(hint, idx, offset);
-            _metrics.used_bytes += sizeof(promoted_index_block);
+            if (_blocks->shared()) {
+                _pending.emplace(idx, offset);
+                return &*_pending;
+            }
+            auto i = _blocks->set().emplace_hint(hint, idx, offset);
+            _blocks->account(sizeof(promoted_index_block));
             ++_metrics.block_count;
             ++_metrics.populations;
             return const_cast<promoted_index_block*>(&*i);
         });
     }
 
+    // Inserts a pending block into the shared set, or merges it into the same
+    // block inserted by another cursor in the meantime.
+    promoted_index_block* publish(promoted_index_block* block) {
+        if (!is_pending(*block)) {
+            return block;
+        }
+        auto& blocks = _blocks->set();
+        auto i = blocks.lower_bound(block->index);
+        if (i == blocks.end() || i->index != block->index) {
+            i = blocks.insert(i, std::move(*_pending));
+            _blocks->account(i->memory_usage());
+            ++_metrics.block_count;
+            ++_metrics.populations;
+        } else if (!i->end && _pending->end) {
+            auto& b = const_cast<promoted_index_block&>(*i);
+            auto mem_before = b.memory_usage();
+            b = std::move(*_pending);
+            _blocks->account(int64_t(b.memory_usage()) - int64_t(mem_before));
+        }
+        _pending.reset();
+        return const_cast<promoted_index_block*>(&*i);
+    }
+
     void erase_range(block_set_type::iterator begin, block_set_type::iterator end) {
         while (begin != end) {
             --_metrics.block_count;
             ++_metrics.evictions;
-            _metrics.used_bytes -= begin->memory_usage();
-            begin = _blocks.erase(begin);
+            _blocks->account(-int64_t(begin->memory_usage()));
+            begin = _blocks->set().erase(begin);
         }
     }
 public:
@@ -265,8 +362,9 @@ class cached_promoted_index {
             column_values_fixed_lengths cvfl,
             cached_file f,
             io_priority_class pc,
-            pi_index_type blocks_count)
-        : _blocks(block_comparator{s})
+            pi_index_type blocks_count,
+            lw_shared_ptr<block_set> blocks = {})
+        : _blocks(blocks ? std::move(blocks) : make_lw_shared<block_set>(s, m))
         , _s(s)
         , _metrics(m)
         , _blocks_count(blocks_count)
@@ -277,14 +375,6 @@ class cached_promoted_index {
         , _block_parser(s, std::move(permit), std::move(cvfl))
     { }
 
-    ~cached_promoted_index() {
-        _metrics.block_count -= _blocks.size();
-        _metrics.evictions += _blocks.size();
-        for (auto&& b : _blocks) {
-            _metrics.used_bytes -= b.memory_usage();
-        }
-    }
-
     /// \brief Returns a pointer to promoted_index_block entry which has at least offset, index and start fields valid.
     future<promoted_index_block*> get_block_with_start(pi_index_type idx, tracing::trace_state_ptr trace_state) {
         return get_block_only_offset(idx, trace_state).then([this, trace_state] (promoted_index_block* block) {
@@ -293,7 +383,7 @@ class cached_promoted_index {
                 return make_ready_future<promoted_index_block*>(block);
             }
             ++_metrics.misses_l1;
-            return read_block_start(*block, trace_state).then([block] { return block; });
+            return read_block_start(*block, trace_state).then([this, block] { return publish(block); });
         });
     }
 
@@ -305,7 +395,7 @@ class cached_promoted_index {
                 return make_ready_future<promoted_index_block*>(block);
             }
             ++_metrics.misses_l2;
-            return read_block(*block, trace_state).then([block] { return block; });
+            return read_block(*block, trace_state).then([this, block] { return publish(block); });
         });
     }
 
@@ -320,8 +410,8 @@ class cached_promoted_index {
     /// Resolving with std::nullopt means the position is not known. The caller should
     /// use the end of the partition as the upper bound.
     future<std::optional<uint64_t>> upper_bound_cache_only(position_in_partition_view pos, tracing::trace_state_ptr trace_state) {
-        auto i = _blocks.upper_bound(pos);
-        if (i == _blocks.end()) {
+        auto i = _blocks->set().upper_bound(pos);
+        if (i == _blocks->set().end()) {
             return make_ready_future<std::optional<uint64_t>>(std::nullopt);
         }
         auto& block = const_cast<promoted_index_block&>(*i);
@@ -337,7 +427,9 @@ class cached_promoted_index {
     void invalidate_prior(promoted_index_block* block, tracing::trace_state_ptr trace_state) {
         _cached_file.invalidate_at_most_front(block->offset, trace_state);
         _cached_file.invalidate_at_most(get_offset_entry_pos(0), get_offset_entry_pos(block->index), trace_state);
-        erase_range(_blocks.begin(), _blocks.lower_bound(block->index));
+        if (!_blocks->shared()) {
+            erase_range(_blocks->set().begin(), _blocks->set().lower_bound(block->index));
+        }
     }
 
     cached_file& file() { return _cached_file; }
@@ -436,10 +528,11 @@ class bsearch_clustered_cursor : public clustered_index_cursor {
             cached_file f,
             io_priority_class pc,
             pi_index_type blocks_count,
-            tracing::trace_state_ptr trace_state)
+            tracing::trace_state_ptr trace_state,
+            lw_shared_ptr<cached_promoted_index::block_set> blocks = {})
         : _s(s)
         , _blocks_count(blocks_count)
-        , _promoted_index(s, metrics, std::move(permit), std::move(cvfl), std::move(f), pc, blocks_count)
+        , _promoted_index(s, metrics, std::move(permit), std::move(cvfl), std::move(f), pc, blocks_count, std::move(blocks))
         , _trace_state(std::move(trace_state))
     { }
 
@@ -27,6 +27,8 @@
 #include "vint-serialization.hh"
 #include "sstables/types.hh"
 #include "sstables/mx/types.hh"
+#include "sstables/partition_trie.hh"
+#include "sstables/write_tracking_file_impl.hh"
 #include "db/config.hh"
 #include "atomic_cell.hh"
 #include "utils/exceptions.hh"
@@ -552,7 +554,10 @@ class writer : public sstable_writer::writer_impl {
     shard_id _shard; // Specifies which shard the new SStable will belong to.
     bool _compression_enabled = false;
     std::unique_ptr<file_writer> _data_writer;
+    lw_shared_ptr<write_throughput_tracker> _data_write_throughput = make_lw_shared<write_throughput_tracker>();
     std::unique_ptr<file_writer> _index_writer;
+    std::unique_ptr<file_writer> _partitions_writer;
+    std::optional<partition_trie_writer> _partition_trie;
     bool _tombstone_written = false;
     bool _static_row_written = false;
     // The length of partition header (partition key, partition deletion and static row, if present)
@@ -800,6 +805,9 @@ class writer : public sstable_writer::writer_impl {
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
         _sst.generate_toc(_schema.get_compressor_params().get_compressor(), _schema.bloom_filter_fp_chance());
+        if (_cfg.write_partition_trie) {
+            _sst._recognized_components.insert(component_type::Partitions);
+        }
         _sst.write_toc(_pc);
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -834,6 +842,7 @@ writer::~writer() {
             }
         }
     };
+    close_writer(_partitions_writer);
     close_writer(_index_writer);
     close_writer(_data_writer);
 }
@@ -884,17 +893,23 @@ void writer::init_file_writers() {
     options.buffer_size = _sst.sstable_buffer_size;
     options.write_behind = 10;
 
+    auto data_file = make_write_tracking_file(std::move(_sst._data_file), _data_write_throughput);
+    auto data_options = make_data_write_options(data_file, _cfg.data_write_buffer_size, _cfg.data_write_in_flight_size, _pc);
     if (!_compression_enabled) {
-        auto out = make_file_data_sink(std::move(_sst._data_file), options).get0();
-        _data_writer = std::make_unique<crc32_checksummed_file_writer>(std::move(out), options.buffer_size, _sst.filename(component_type::Data));
+        auto out = make_file_data_sink(std::move(data_file), data_options).get0();
+        _data_writer = std::make_unique<crc32_checksummed_file_writer>(std::move(out), data_options.buffer_size, _sst.filename(component_type::Data));
     } else {
-        auto out = make_file_output_stream(std::move(_sst._data_file), options).get0();
+        auto out = make_file_output_stream(std::move(data_file), data_options).get0();
         _data_writer = std::make_unique<file_writer>(
             make_compressed_file_m_format_output_stream(
                 std::move(out),
                 &_sst._components->compression,
                 _schema.get_compressor_params()), _sst.filename(component_type::Data));
     }
+    if (_sst.has_partition_trie()) {
+        _partitions_writer = std::make_unique<file_writer>(_sst.make_component_file_writer(component_type::Partitions, options).get0());
+        _partition_trie.emplace(*_partitions_writer);
+    }
     auto w = file_writer::make(std::move(_sst._index_file), std::move(options), _sst.filename(component_type::Index));
     _index_writer = std::make_unique<file_writer>(w.get0());
 }
@@ -907,6 +922,7 @@ std::unique_ptr<file_writer> writer::close_writer(std::unique_ptr<file_writer>&
 
 void writer::close_data_writer() {
     auto writer = close_writer(_data_writer);
+    report_data_write_throughput(*_data_write_throughput, _sst.filename(component_type::Data));
     if (!_compression_enabled) {
         auto chksum_wr = static_cast<crc32_checksummed_file_writer*>(writer.get());
         _sst.write_digest(chksum_wr->full_checksum());
@@ -1000,6 +1016,10 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     _sst._components->filter->add(bytes_view(*_partition_key));
     _collector.add_key(bytes_view(*_partition_key));
 
+    if (_partition_trie) {
+        _partition_trie->add(dk.token(), bytes_view(*_partition_key), _index_writer->offset());
+    }
+
     auto p_key = disk_string_view<uint16_t>();
     p_key.value = bytes_view(*_partition_key);
 
@@ -1487,6 +1507,10 @@ void writer::consume_end_of_stream() {
         _collector.add_compression_ratio(_sst._components->compression.compressed_file_length(), _sst._components->compression.uncompressed_file_length());
     }
 
+    if (_partition_trie) {
+        _partition_trie->finish(_index_writer->offset());
+        close_writer(_partitions_writer);
+    }
     close_writer(_index_writer);
     _sst.set_first_and_last_keys();
 
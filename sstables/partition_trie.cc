@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <seastar/core/byteorder.hh>
+
+#include "sstables/partition_trie.hh"
+#include "sstables/writer.hh"
+#include "sstables/exceptions.hh"
+#include "vint-serialization.hh"
+
+namespace sstables {
+
+static constexpr uint8_t node_has_payload = 0x1;
+static constexpr size_t footer_size = sizeof(uint64_t);
+
+bytes partition_trie_key(const dht::token& token, bytes_view key) {
+    bytes ret(bytes::initialized_later(), sizeof(uint64_t) + key.size());
+    auto flipped = uint64_t(token.raw()) ^ (uint64_t(1) << 63);
+    write_be(reinterpret_cast<char*>(ret.begin()), flipped);
+    std::copy(key.begin(), key.end(), ret.begin() + sizeof(uint64_t));
+    return ret;
+}
+
+static size_t common_prefix_length(bytes_view a, bytes_view b) {
+    return std::mismatch(a.begin(), a.begin() + std::min(a.size(), b.size()), b.begin()).first - a.begin();
+}
+
+uint64_t partition_trie_writer::write_node(const node& n) {
+    auto pos = _out.offset();
+    uint8_t flags = n.payload ? node_has_payload : 0;
+    _out.write(reinterpret_cast<const char*>(&flags), 1);
+    if (n.payload) {
+        write_vint(_out, n.payload->index_position);
+        write_vint(_out, n.payload->index_length);
+    }
+    write_vint(_out, uint64_t(n.children.size()));
+    for (auto& [transition, child_pos] : n.children) {
+        _out.write(reinterpret_cast<const char*>(&transition), 1);
+        write_vint(_out, pos - child_pos);
+    }
+    return pos;
+}
+
+// Writes the nodes of the path deeper than depth, which the next prefixes
+// can't reach anymore.
+void partition_trie_writer::write_path_below(size_t depth) {
+    while (_path.size() > depth + 1) {
+        auto pos = write_node(_path.back());
+        auto transition = _path.back().transition;
+        _path.pop_back();
+        _path.back().children.emplace_back(transition, pos);
+    }
+}
+
+void partition_trie_writer::insert(bytes_view prefix, partition_trie_payload payload) {
+    if (_path.empty()) {
+        _path.push_back(node{});
+    }
+    auto common = common_prefix_length(prefix, _last_prefix);
+    write_path_below(common);
+    for (auto i = common; i < prefix.size(); ++i) {
+        _path.push_back(node{uint8_t(prefix[i])});
+    }
+    _path.back().payload = payload;
+    _last_prefix = bytes(prefix);
+}
+
+void partition_trie_writer::insert_pending(const pending_key* next, uint64_t index_end) {
+    auto& k = _pending.front();
+    auto common_with_next = next ? common_prefix_length(k.key, next->key) : 0;
+    auto prefix_length = std::min(std::max(_common_prefix_with_previous, common_with_next) + 1, k.key.size());
+    insert(bytes_view(k.key).substr(0, prefix_length), partition_trie_payload{k.index_position, index_end - k.index_position});
+    _common_prefix_with_previous = common_with_next;
+    _pending.pop_front();
+}
+
+void partition_trie_writer::add(const dht::token& token, bytes_view key, uint64_t index_position) {
+    _pending.push_back(pending_key{partition_trie_key(token, key), index_position});
+    if (_pending.size() == 3) {
+        insert_pending(&_pending[1], _pending[2].index_position);
+    }
+}
+
+void partition_trie_writer::finish(uint64_t index_size) {
+    while (!_pending.empty()) {
+        insert_pending(_pending.size() > 1 ? &_pending[1] : nullptr, index_size);
+    }
+    if (_path.empty()) {
+        _path.push_back(node{});
+    }
+    write_path_below(0);
+    auto root = write_node(_path.back());
+    _path.clear();
+    char footer[footer_size];
+    write_be(footer, root);
+    _out.write(footer, footer_size);
+}
+
+namespace {
+
+// Sequential reader of the bytes of a node.
+class node_reader {
+    cached_file::stream _stream;
+    temporary_buffer<char> _buf;
+    const sstring& _file_name;
+public:
+    node_reader(cached_file::stream stream, const sstring& file_name)
+        : _stream(std::move(stream))
+        , _file_name(file_name)
+    { }
+
+    future<uint8_t> read_byte() {
+        while (_buf.empty()) {
+            _buf = co_await _stream.next();
+            if (_buf.empty()) {
+                throw malformed_sstable_exception("unexpected end of partition trie", _file_name);
+            }
+        }
+        uint8_t b = _buf[0];
+        _buf.trim_front(1);
+        co_return b;
+    }
+
+    future<uint64_t> read_vint() {
+        std::array<bytes::value_type, max_vint_length> encoded;
+        encoded[0] = co_await read_byte();
+        auto size = unsigned_vint::serialized_size_from_first_byte(encoded[0]);
+        for (vint_size_type i = 1; i < size; ++i) {
+            encoded[i] = co_await read_byte();
+        }
+        co_return unsigned_vint::deserialize(bytes_view(encoded.data(), size));
+    }
+};
+
+}
+
+partition_trie_reader::partition_trie_reader(file f, uint64_t size, reader_permit permit, cached_file::metrics& m, size_t max_cached_bytes, sstring file_name)
+    : _file(std::move(f), std::move(permit), m, 0, size, file_name)
+    , _file_name(std::move(file_name))
+    , _max_cached_bytes(max_cached_bytes)
+{ }
+
+void partition_trie_reader::trim_cache() noexcept {
+    if (_file.cached_bytes() > _max_cached_bytes && _file.size() > _max_cached_bytes) {
+        _file.invalidate_at_most(0, _file.size() - _max_cached_bytes);
+    }
+}
+
+future<uint64_t> partition_trie_reader::read_root(const io_priority_class& pc) {
+    if (_file.size() < footer_size) {
+        throw malformed_sstable_exception("partition trie too short", _file_name);
+    }
+    node_reader r(_file.read(_file.size() - footer_size, pc), _file_name);
+    uint64_t root = 0;
+    for (size_t i = 0; i < footer_size; ++i) {
+        root = (root << 8) | co_await r.read_byte();
+    }
+    if (root >= _file.size() - footer_size) {
+        throw malformed_sstable_exception(format("bad partition trie root position {}", root), _file_name);
+    }
+    co_return root;
+}
+
+future<std::optional<partition_trie_payload>> partition_trie_reader::lookup(bytes key, const io_priority_class& pc) {
+    // Trimmed before the walk rather than after it, so that the cache holds at
+    // most the pages of a single lookup above the limit.
+    trim_cache();
+    if (!_root) {
+        _root = co_await read_root(pc);
+    }
+    auto pos = *_root;
+    for (size_t depth = 0;; ++depth) {
+        node_reader r(_file.read(pos, pc), _file_name);
+        auto flags = co_await r.read_byte();
+        std::optional<partition_trie_payload> payload;
+        if (flags & node_has_payload) {
+            payload.emplace();
+            payload->index_position = co_await r.read_vint();
+            payload->index_length = co_await r.read_vint();
+        }
+        auto children = co_await r.read_vint();
+        // A node without children ends the unique prefix of a key, and so does
+        // a node with a payload at the end of the looked up key. A node with
+        // both a payload and children holds a key which is a prefix of others.
+        if (depth == key.size() || !children) {
+            co_return payload;
+        }
+        auto wanted = uint8_t(key[depth]);
+        std::optional<uint64_t> next;
+        for (uint64_t i = 0; i < children; ++i) {
+            auto transition = co_await r.read_byte();
+            auto delta = co_await r.read_vint();
+            if (transition >= wanted) {
+                if (transition == wanted) {
+                    if (delta == 0 || delta > pos) {
+                        throw malformed_sstable_exception(format("bad partition trie child offset {} at {}", delta, pos), _file_name);
+                    }
+                    next = pos - delta;
+                }
+                break;
+            }
+        }
+        if (!next) {
+            co_return std::nullopt;
+        }
+        pos = *next;
+    }
+}
+
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include <seastar/core/file.hh>
+#include "bytes.hh"
+#include "dht/token.hh"
+#include "reader_permit.hh"
+#include "utils/cached_file.hh"
+
+namespace sstables {
+
+class file_writer;
+
+// The Partitions.db component of mx sstables: a trie of the partition keys of
+// the sstable in their byte-comparable form (see partition_trie_key()), which
+// leads a point lookup to the entry of its partition in Index.db in as many
+// steps as there are bytes in the shortest prefix telling the key apart from
+// its neighbours, without going through the Summary.
+//
+// Only that unique prefix of every key is stored, so a lookup of a key which
+// isn't in the sstable can end up on the entry of a partition sharing the
+// prefix; the caller has to compare the key of the entry it reads.
+//
+// Layout: nodes are written children first, each as
+//
+//   flags: byte (has_payload)
+//   [index_position: vint, index_length: vint]  if has_payload
+//   children_count: vint
+//   children_count * (transition: byte, (node position - child position): vint)
+//
+// with the children in increasing order of transition bytes, and followed by
+// the position of the root node as a big-endian uint64.
+
+// Index.db range of the entry of a partition and of the one following it, if
+// any, so that reading it is enough to bound the partition in Data.db.
+struct partition_trie_payload {
+    uint64_t index_position;
+    uint64_t index_length;
+};
+
+// Returns the byte-comparable form of a partition key: the token, with its sign
+// bit flipped so that its big-endian bytes compare like tokens do, followed by
+// the serialized key, which orders partitions of the same token.
+bytes partition_trie_key(const dht::token& token, bytes_view key);
+
+// Writes the trie of the keys added to it, which must come in the order of
+// partitions in the sstable. Must be used in a seastar thread.
+class partition_trie_writer {
+    struct node {
+        uint8_t transition;
+        std::optional<partition_trie_payload> payload;
+        // Transition bytes of the written children and their positions.
+        std::vector<std::pair<uint8_t, uint64_t>> children;
+    };
+    struct pending_key {
+        bytes key;
+        uint64_t index_position;
+    };
+
+    file_writer& _out;
+    // Nodes on the path to the last inserted prefix, starting with the root.
+    // Nodes are written once the path moves away from them.
+    std::vector<node> _path;
+    bytes _last_prefix;
+    // The unique prefix of a key is only known once the next key is, and its
+    // payload once the key after the next one is.
+    std::deque<pending_key> _pending;
+    size_t _common_prefix_with_previous = 0;
+private:
+    uint64_t write_node(const node& n);
+    void write_path_below(size_t depth);
+    void insert(bytes_view prefix, partition_trie_payload payload);
+    void insert_pending(const pending_key* next, uint64_t index_end);
+public:
+    explicit partition_trie_writer(file_writer& out) noexcept : _out(out) {}
+
+    void add(const dht::token& token, bytes_view key, uint64_t index_position);
+
+    // Writes out the rest of the trie, given the size of Index.db.
+    void finish(uint64_t index_size);
+};
+
+// Looks up keys in a Partitions.db file, through a page cache kept by the
+// sstable, so that all reads of the sstable share the top of the trie.
+//
+// Nodes are written after their children, so the top of the trie sits at the
+// end of the file. Once more than max_cached_bytes are cached, the pages which
+// are further than that from the end of the file are dropped.
+class partition_trie_reader {
+    cached_file _file;
+    sstring _file_name;
+    size_t _max_cached_bytes;
+    std::optional<uint64_t> _root;
+private:
+    future<uint64_t> read_root(const io_priority_class& pc);
+    void trim_cache() noexcept;
+public:
+    partition_trie_reader(file f, uint64_t size, reader_permit permit, cached_file::metrics& m, size_t max_cached_bytes, sstring file_name);
+
+    size_t cached_bytes() const noexcept {
+        return _file.cached_bytes();
+    }
+
+    // Returns the Index.db range holding the entry of the only partition of the
+    // sstable which can have the given byte-comparable key, or std::nullopt if
+    // the key is certainly not in the sstable.
+    future<std::optional<partition_trie_payload>> lookup(bytes key, const io_priority_class& pc);
+};
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sstables/promoted_index_cache.hh"
+
+#include <algorithm>
+
+namespace sstables {
+
+promoted_index_cache::promoted_index_cache(stats& s, size_t max_bytes)
+    : _stats(s)
+    , _max_bytes(max_bytes)
+{ }
+
+promoted_index_cache::~promoted_index_cache() {
+    for (auto& [sst, entries] : _entries) {
+        _stats.entries -= entries.size();
+    }
+}
+
+void promoted_index_cache::evict(entry& e) noexcept {
+    ++_stats.evictions;
+    --_stats.entries;
+    auto i = _entries.find(e.sst);
+    i->second.erase(e.position);
+    if (i->second.empty()) {
+        _entries.erase(i);
+    }
+}
+
+lw_shared_ptr<promoted_index_cache::block_set>
+promoted_index_cache::get(const sstable& sst, uint64_t position, const schema& s, mc::cached_promoted_index::metrics& m) {
+    auto& entries = _entries[&sst];
+    auto [i, inserted] = entries.try_emplace(position);
+    auto& e = i->second;
+    if (inserted) {
+        ++_stats.misses;
+        ++_stats.entries;
+        e.sst = &sst;
+        e.position = position;
+        e.blocks = make_lw_shared<block_set>(s, m, &_stats.used_bytes, std::max<size_t>(_max_bytes / max_entry_fraction, 1));
+    } else {
+        ++_stats.hits;
+        e.lru_link.unlink();
+    }
+    _lru.push_back(e);
+
+    // Blocks are parsed into the sets after they're handed out, so the
+    // limit is enforced when the next partition is looked up. The entry
+    // handed out stays, it takes a bounded share of the limit.
+    auto blocks = e.blocks;
+    while (_stats.used_bytes > _max_bytes && &_lru.front() != &e) {
+        evict(_lru.front());
+    }
+    return blocks;
+}
+
+void promoted_index_cache::invalidate(const sstable& sst) noexcept {
+    auto i = _entries.find(&sst);
+    if (i != _entries.end()) {
+        _stats.evictions += i->second.size();
+        _stats.entries -= i->second.size();
+        _entries.erase(i);
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <boost/intrusive/list.hpp>
+
+#include "sstables/mx/bsearch_clustered_cursor.hh"
+
+namespace sstables {
+
+class sstable;
+
+// Keeps the parsed promoted index blocks of recently read partitions across
+// reads, so that repeated slices of the same wide partition skip reading and
+// parsing the blocks their binary search goes through again.
+//
+// Entries are keyed by sstable and by the position of the promoted index in
+// its Index.db. They are evicted in LRU order once the blocks of all of them
+// take more memory than the limit, and when their sstable goes away.
+//
+// A single entry takes at most 1/max_entry_fraction of the limit. Reads which
+// need more blocks of the partition keep them privately, and drop the ones
+// behind them as they go, like without the cache.
+class promoted_index_cache {
+public:
+    using block_set = mc::cached_promoted_index::block_set;
+
+    static constexpr size_t max_entry_fraction = 16;
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t entries = 0;
+        // Memory used by the blocks of all entries, including the evicted
+        // ones which are still used by a read.
+        uint64_t used_bytes = 0;
+    };
+private:
+    using lru_link_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+
+    struct entry {
+        const sstable* sst;
+        uint64_t position;
+        lw_shared_ptr<block_set> blocks;
+        lru_link_type lru_link;
+    };
+
+    using lru_type = boost::intrusive::list<entry,
+            boost::intrusive::member_hook<entry, lru_link_type, &entry::lru_link>,
+            boost::intrusive::constant_time_size<false>>;
+
+    stats& _stats;
+    size_t _max_bytes;
+    // Least recently used first.
+    lru_type _lru;
+    std::unordered_map<const sstable*, std::unordered_map<uint64_t, entry>> _entries;
+private:
+    void evict(entry& e) noexcept;
+public:
+    promoted_index_cache(stats& s, size_t max_bytes);
+    ~promoted_index_cache();
+
+    promoted_index_cache(const promoted_index_cache&) = delete;
+    promoted_index_cache& operator=(const promoted_index_cache&) = delete;
+
+    const stats& get_stats() const noexcept {
+        return _stats;
+    }
+
+    bool enabled() const noexcept {
+        return _max_bytes;
+    }
+
+    // Returns the shared blocks of the promoted index at the given position
+    // of the Index.db of sst. Must only be called when enabled().
+    lw_shared_ptr<block_set> get(const sstable& sst, uint64_t position, const schema& s, mc::cached_promoted_index::metrics& m);
+
+    // Drops the entries of an sstable which is going away.
+    void invalidate(const sstable& sst) noexcept;
+};
+
+}
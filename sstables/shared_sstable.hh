@@ -26,6 +26,7 @@
 #include <functional>
 #include <unordered_set>
 #include <seastar/core/shared_ptr.hh>
+#include <seastar/util/bool_class.hh>
 
 namespace sstables {
 
@@ -48,6 +49,14 @@ namespace sstables {
 using shared_sstable = seastar::lw_shared_ptr<sstable>;
 using sstable_list = std::unordered_set<shared_sstable>;
 
+// Whether a sstable is added off-strategy, i.e. kept out of the compaction
+// strategy until it is reshaped into the table's layout.
+using offstrategy = seastar::bool_class<class offstrategy_tag>;
+
+// Whether loading a sstable leaves out the components which are only needed
+// to look up partitions, to be loaded on first access instead.
+using defer_components = seastar::bool_class<class defer_components_tag>;
+
 }
 
 
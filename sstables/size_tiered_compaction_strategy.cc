@@ -183,7 +183,7 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(column_family& cfs,
     }
 
     // if there is no sstable to compact in standard way, try compacting single sstable whose droppable tombstone
-    // ratio is greater than threshold.
+    // ratio is greater than threshold, along with the overlapping sstables that hold data its tombstones may shadow.
     // prefer oldest sstables from biggest size tiers because they will be easier to satisfy conditions for
     // tombstone purge, i.e. less likely to shadow even older data.
     for (auto&& sstables : buckets | boost::adaptors::reversed) {
@@ -199,7 +199,7 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(column_family& cfs,
         auto it = std::min_element(sstables.begin(), sstables.end(), [] (auto& i, auto& j) {
             return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
         });
-        return sstables::compaction_descriptor({ *it }, cfs.get_sstable_set(), service::get_local_compaction_priority());
+        return make_tombstone_compaction_job(cfs, *it, candidates);
     }
     return sstables::compaction_descriptor();
 }
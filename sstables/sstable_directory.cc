@@ -20,6 +20,8 @@
  */
 
 #include <boost/range/adaptor/map.hpp>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/gate.hh>
 #include "sstables/sstable_directory.hh"
 #include "sstables/sstables.hh"
 #include "sstables/compaction_manager.hh"
@@ -106,22 +108,27 @@ void sstable_directory::validate(sstables::shared_sstable sst) const {
     }
 }
 
-future<>
-sstable_directory::process_descriptor(sstables::entry_descriptor desc, const ::io_priority_class& iop, bool sort_sstables_according_to_owner) {
+future<sstables::shared_sstable>
+sstable_directory::load_sstable(sstables::entry_descriptor desc, const ::io_priority_class& iop) {
     if (desc.version > _max_version_seen) {
         _max_version_seen = desc.version;
     }
 
     auto sst = _sstable_object_from_existing_sstable(_sstable_dir, desc.generation, desc.version, desc.format);
-    return sst->load(iop).then([this, sst] {
+    return sst->load(iop, sstables::defer_components(sst->manager().defer_component_loading())).then([this, sst] {
         validate(sst);
-        if (_need_mutate_level) {
-            dirlog.trace("Mutating {} to level 0\n", sst->get_filename());
-            return sst->mutate_sstable_level(0);
-        } else {
-            return make_ready_future<>();
-        }
-    }).then([sst, sort_sstables_according_to_owner, this] {
+        return sst;
+    });
+}
+
+future<>
+sstable_directory::process_loaded_sstable(sstables::shared_sstable sst, bool sort_sstables_according_to_owner) {
+    auto mutated = make_ready_future<>();
+    if (_need_mutate_level) {
+        dirlog.trace("Mutating {} to level 0\n", sst->get_filename());
+        mutated = sst->mutate_sstable_level(0);
+    }
+    return mutated.then([sst, sort_sstables_according_to_owner, this] {
         if (sort_sstables_according_to_owner) {
             return sort_sstable(sst);
         } else {
@@ -134,16 +141,17 @@ sstable_directory::process_descriptor(sstables::entry_descriptor desc, const ::i
 
 future<>
 sstable_directory::sort_sstable(sstables::shared_sstable sst) {
-    return sst->get_open_info().then([sst, this] (sstables::foreign_sstable_open_info info) {
-        auto shards = sst->get_shards_for_this_sstable();
+    auto shards = sst->get_shards_for_this_sstable();
+    if (shards.size() == 1 && shards[0] == this_shard_id()) {
+        // Local sstables aren't shared, so they can keep their components deferred.
+        dirlog.trace("{} identified as a local unshared SSTable", sst->get_filename());
+        _unshared_local_sstables.push_back(sst);
+        return make_ready_future<>();
+    }
+    return sst->get_open_info().then([sst, shards = std::move(shards), this] (sstables::foreign_sstable_open_info info) {
         if (shards.size() == 1) {
-            if (shards[0] == this_shard_id()) {
-                dirlog.trace("{} identified as a local unshared SSTable", sst->get_filename());
-                _unshared_local_sstables.push_back(sst);
-            } else {
-                dirlog.trace("{} identified as a remote unshared SSTable", sst->get_filename());
-                _unshared_remote_sstables[shards[0]].push_back(std::move(info));
-            }
+            dirlog.trace("{} identified as a remote unshared SSTable", sst->get_filename());
+            _unshared_remote_sstables[shards[0]].push_back(std::move(info));
         } else {
             dirlog.trace("{} identified as a shared SSTable", sst->get_filename());
             _shared_sstable_info.push_back(std::move(info));
@@ -177,57 +185,126 @@ sstable_directory::process_sstable_dir(const ::io_priority_class& iop, bool sort
     //   to make sure they all update their own version of scan_state and then merge it.
     // - If all shards scan in parallel, they can start loading sooner. That is faster than having
     //   a separate step to fetch all files, followed by another step to distribute and process.
-    return do_with(scan_state{}, [this, sort_sstables_according_to_owner, &iop] (scan_state& state) {
-        return lister::scan_dir(_sstable_dir, { directory_entry_type::regular },
-                [this, sort_sstables_according_to_owner, &state] (fs::path parent_dir, directory_entry de) {
+    //
+    // Loading an sstable, which reads its TOC, Statistics and other small components, starts as
+    // soon as its TOC is listed, so that it overlaps with listing the rest of the directory. Loads
+    // are bounded by _load_parallelism and by the shared _load_semaphore. The listing waits for
+    // a free slot before going on, so a large directory can't queue up an unbounded number of them.
+    // Whether an sstable is kept is only decided once the whole directory is listed, since a
+    // temporary TOC of the same generation can be listed after its TOC.
+    scan_state state;
+    semaphore load_slots(_load_parallelism);
+    gate loads;
+    std::unordered_map<int64_t, sstables::shared_sstable> loaded;
+    std::unordered_map<int64_t, std::exception_ptr> failed;
+    auto start = std::chrono::steady_clock::now();
+    auto loads_done = start;
+
+    auto start_load = [this, &load_slots, &loads, &loaded, &failed, &loads_done, &iop] (sstables::entry_descriptor desc) {
+        return get_units(load_slots, 1).then([this, &loads, &loaded, &failed, &loads_done, &iop, desc = std::move(desc)] (semaphore_units<> slot) mutable {
+            auto generation = desc.generation;
+            (void)with_gate(loads, [this, &loaded, &failed, &loads_done, &iop, generation, desc = std::move(desc), slot = std::move(slot)] () mutable {
+                return with_semaphore(_load_semaphore, 1, [this, &iop, desc = std::move(desc)] () mutable {
+                    return load_sstable(std::move(desc), iop);
+                }).then_wrapped([&loaded, &failed, &loads_done, generation, slot = std::move(slot)] (future<sstables::shared_sstable> f) {
+                    if (f.failed()) {
+                        failed.emplace(generation, f.get_exception());
+                    } else {
+                        loaded.emplace(generation, f.get0());
+                    }
+                    loads_done = std::chrono::steady_clock::now();
+                });
+            });
+        });
+    };
+
+    std::exception_ptr listing_error;
+    try {
+        co_await lister::scan_dir(_sstable_dir, { directory_entry_type::regular },
+                [this, &state, &start_load] (fs::path parent_dir, directory_entry de) {
             auto comps = sstables::entry_descriptor::make_descriptor(_sstable_dir.native(), de.name);
+            auto is_local_toc = comps.component == component_type::TOC && (comps.generation % smp::count) == this_shard_id();
+            auto generation = comps.generation;
             handle_component(state, std::move(comps), parent_dir / fs::path(de.name));
-            return make_ready_future<>();
-        }, &manifest_json_filter).then([this, sort_sstables_according_to_owner, &state, &iop] {
-            // Always okay to delete files with a temporary TOC. We want to do it before we process
-            // the generations seen: it's okay to reuse those generations since the files will have
-            // been deleted anyway.
-            for (auto& desc: state.temp_toc_found) {
-                auto range = state.generations_found.equal_range(desc.generation);
-                for (auto it = range.first; it != range.second; ++it) {
-                    auto& path = it->second;
-                    dirlog.trace("Scheduling to remove file {}, from an SSTable with a Temporary TOC", path.native());
-                    _files_for_removal.insert(path.native());
-                }
-                state.generations_found.erase(range.first, range.second);
-                state.descriptors.erase(desc.generation);
+            if (!is_local_toc) {
+                return make_ready_future<>();
             }
+            return start_load(state.descriptors.at(generation));
+        }, &manifest_json_filter);
+    } catch (...) {
+        listing_error = std::current_exception();
+    }
+    auto listed = std::chrono::steady_clock::now();
+    co_await loads.close();
+    if (listing_error) {
+        std::rethrow_exception(listing_error);
+    }
 
-            _max_generation_seen =  boost::accumulate(state.generations_found | boost::adaptors::map_keys, int64_t(0), [] (int64_t a, int64_t b) {
-                return std::max<int64_t>(a, b);
-            });
+    // Always okay to delete files with a temporary TOC. We want to do it before we process
+    // the generations seen: it's okay to reuse those generations since the files will have
+    // been deleted anyway.
+    for (auto& desc: state.temp_toc_found) {
+        auto range = state.generations_found.equal_range(desc.generation);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto& path = it->second;
+            dirlog.trace("Scheduling to remove file {}, from an SSTable with a Temporary TOC", path.native());
+            _files_for_removal.insert(path.native());
+        }
+        state.generations_found.erase(range.first, range.second);
+        state.descriptors.erase(desc.generation);
+        loaded.erase(desc.generation);
+        failed.erase(desc.generation);
+    }
 
-            dirlog.debug("After {} scanned, seen generation {}. {} descriptors found, {} different files found ",
-                    _sstable_dir, _max_generation_seen, state.descriptors.size(), state.generations_found.size());
-
-            // _descriptors is everything with a TOC. So after we remove this, what's left is
-            // SSTables for which a TOC was not found.
-            return parallel_for_each_restricted(state.descriptors, [this, sort_sstables_according_to_owner, &state, &iop] (std::tuple<int64_t, sstables::entry_descriptor>&& t) {
-                auto& desc = std::get<1>(t);
-                state.generations_found.erase(desc.generation);
-                // This will try to pre-load this file and throw an exception if it is invalid
-                return process_descriptor(std::move(desc), iop, sort_sstables_according_to_owner);
-            }).then([this, &state] {
-                // For files missing TOC, it depends on where this is coming from.
-                // If scylla was supposed to have generated this SSTable, this is not okay and
-                // we refuse to proceed. If this coming from, say, an import, then we just delete,
-                // log and proceed.
-                for (auto& path : state.generations_found | boost::adaptors::map_values) {
-                    if (_throw_on_missing_toc) {
-                        throw sstables::malformed_sstable_exception(format("At directory: {}: no TOC found for SSTable {}!. Refusing to boot", _sstable_dir.native(), path.native()));
-                    } else {
-                        dirlog.info("Found incomplete SSTable {} at directory {}. Removing", path.native(), _sstable_dir.native());
-                        _files_for_removal.insert(path.native());
-                    }
-                }
-            });
-        });
+    _max_generation_seen =  boost::accumulate(state.generations_found | boost::adaptors::map_keys, int64_t(0), [] (int64_t a, int64_t b) {
+        return std::max<int64_t>(a, b);
     });
+
+    dirlog.debug("After {} scanned, seen generation {}. {} descriptors found, {} different files found ",
+            _sstable_dir, _max_generation_seen, state.descriptors.size(), state.generations_found.size());
+
+    // Loading an invalid sstable throws, unless a temporary TOC tells it's an unfinished one.
+    if (!failed.empty()) {
+        std::rethrow_exception(failed.begin()->second);
+    }
+
+    // _descriptors is everything with a TOC. So after we remove this, what's left is
+    // SSTables for which a TOC was not found.
+    for (auto& generation : state.descriptors | boost::adaptors::map_keys) {
+        state.generations_found.erase(generation);
+    }
+    auto sstables = boost::copy_range<std::vector<sstables::shared_sstable>>(loaded | boost::adaptors::map_values);
+    loaded.clear();
+    auto sstables_count = sstables.size();
+    co_await parallel_for_each_restricted(std::move(sstables), [this, sort_sstables_according_to_owner] (sstables::shared_sstable& sst) {
+        return process_loaded_sstable(sst, sort_sstables_according_to_owner);
+    });
+    auto sorted = std::chrono::steady_clock::now();
+
+    // For files missing TOC, it depends on where this is coming from.
+    // If scylla was supposed to have generated this SSTable, this is not okay and
+    // we refuse to proceed. If this coming from, say, an import, then we just delete,
+    // log and proceed.
+    for (auto& path : state.generations_found | boost::adaptors::map_values) {
+        if (_throw_on_missing_toc) {
+            throw sstables::malformed_sstable_exception(format("At directory: {}: no TOC found for SSTable {}!. Refusing to boot", _sstable_dir.native(), path.native()));
+        } else {
+            dirlog.info("Found incomplete SSTable {} at directory {}. Removing", path.native(), _sstable_dir.native());
+            _files_for_removal.insert(path.native());
+        }
+    }
+
+    loads_done = std::max(loads_done, listed);
+    _process_stats = process_stats{
+        .sstables = sstables_count,
+        .listing = listed - start,
+        .loading = loads_done - start,
+        .sorting = sorted - loads_done,
+    };
+    sstables_stats().on_directory_processed(_process_stats.sstables, _process_stats.listing, _process_stats.loading, _process_stats.sorting);
+    dirlog.debug("Processed {} SSTables of {} in {:.3f}s: listing {:.3f}s, loading {:.3f}s, sorting {:.3f}s", sstables_count, _sstable_dir,
+            std::chrono::duration<double>(sorted - start).count(), std::chrono::duration<double>(_process_stats.listing).count(),
+            std::chrono::duration<double>(_process_stats.loading).count(), std::chrono::duration<double>(_process_stats.sorting).count());
 }
 
 future<>
@@ -29,6 +29,7 @@
 #include <unordered_set>
 #include <vector>
 #include <functional>
+#include <chrono>
 #include "seastarx.hh"
 #include "sstables/shared_sstable.hh"            // sstables::shared_sstable
 #include "sstables/version.hh"                   // sstable versions
@@ -61,6 +62,16 @@ class sstable_directory {
     // favor chunked vectors when dealing with file lists: they can grow to hundreds of thousands
     // of elements.
     using sstable_info_vector = utils::chunked_vector<sstables::foreign_sstable_open_info>;
+
+    // Wall-clock time process_sstable_dir() spent listing the directory, loading
+    // the sstables found, which starts as soon as their TOC is listed and so
+    // overlaps with the listing, and sorting them by owner.
+    struct process_stats {
+        size_t sstables = 0;
+        std::chrono::steady_clock::duration listing{};
+        std::chrono::steady_clock::duration loading{};
+        std::chrono::steady_clock::duration sorting{};
+    };
 private:
     using scan_multimap = std::unordered_multimap<int64_t, std::filesystem::path>;
     using scan_descriptors = utils::chunked_vector<sstables::entry_descriptor>;
@@ -118,7 +129,10 @@ class sstable_directory {
     // the amount of data resharded per shard, so a coordinator may redistribute this.
     sstable_info_vector _shared_sstable_info;
 
-    future<> process_descriptor(sstables::entry_descriptor desc, const ::io_priority_class& iop, bool sort_sstables_according_to_owner = true);
+    process_stats _process_stats;
+
+    future<sstables::shared_sstable> load_sstable(sstables::entry_descriptor desc, const ::io_priority_class& iop);
+    future<> process_loaded_sstable(sstables::shared_sstable sst, bool sort_sstables_according_to_owner);
     void validate(sstables::shared_sstable sst) const;
     void handle_component(scan_state& state, sstables::entry_descriptor desc, std::filesystem::path filename);
     future<> remove_input_sstables_from_resharding(std::vector<sstables::shared_sstable> sstlist);
@@ -169,6 +183,11 @@ class sstable_directory {
     // class in a sharded service have the opportunity to validate its files.
     future<> process_sstable_dir(const ::io_priority_class& iop, bool sort_sstables_according_to_owner = true);
 
+    // Timings of the last process_sstable_dir() call.
+    const process_stats& get_process_stats() const noexcept {
+        return _process_stats;
+    }
+
     // Sort the sstable according to owner
     future<> sort_sstable(sstables::shared_sstable sst);
 
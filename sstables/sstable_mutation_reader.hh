@@ -395,6 +395,7 @@ class sstable_mutation_reader : public mp_row_consumer_reader {
         return bool(_context);
     }
     future<> initialize() {
+        co_await _sst->load_deferred_components(_consumer.io_priority());
         if (_single_partition_read) {
             _sst->get_stats().on_single_partition_read();
             const auto& key = dht::ring_position_view(_pr.start()->value());
@@ -21,6 +21,7 @@
 
 #include <boost/icl/interval_map.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/transformed.hpp>
 
 #include "compatible_ring_position.hh"
 #include "compaction_strategy_impl.hh"
@@ -152,6 +153,105 @@ sstable_set::make_incremental_selector() const {
     return incremental_selector(_impl->make_incremental_selector(), *_schema);
 }
 
+sstable_interval_index::sstable_interval_index(schema_ptr schema, std::vector<shared_sstable> sstables)
+        : _schema(std::move(schema)) {
+    _entries.reserve(sstables.size());
+    for (auto& sst : sstables) {
+        auto* first = &sst->get_first_decorated_key();
+        auto* last = &sst->get_last_decorated_key();
+        _entries.push_back(entry{std::move(sst), first, last, nullptr});
+    }
+    dht::ring_position_less_comparator less(*_schema);
+    std::stable_sort(_entries.begin(), _entries.end(), [&less] (const entry& a, const entry& b) {
+        return less(*a.first, *b.first);
+    });
+    build(0, _entries.size());
+}
+
+const dht::decorated_key* sstable_interval_index::build(size_t b, size_t e) {
+    if (b == e) {
+        return nullptr;
+    }
+    auto m = b + (e - b) / 2;
+    auto& n = _entries[m];
+    n.max_last = n.last;
+    dht::ring_position_comparator cmp(*_schema);
+    for (auto* last : {build(b, m), build(m + 1, e)}) {
+        if (last && cmp(*last, *n.max_last) > 0) {
+            n.max_last = last;
+        }
+    }
+    return n.max_last;
+}
+
+template <typename Func>
+void sstable_interval_index::visit(size_t b, size_t e, dht::ring_position_view start, dht::ring_position_view end, bool end_inclusive, Func& func) const {
+    dht::ring_position_comparator cmp(*_schema);
+    while (b != e) {
+        auto m = b + (e - b) / 2;
+        auto& n = _entries[m];
+        // Nothing in this sub-tree reaches the start of the range.
+        if (cmp(start, dht::ring_position_view::for_after_key(*n.max_last)) >= 0) {
+            return;
+        }
+        visit(b, m, start, end, end_inclusive, func);
+        // Neither this entry nor those after it start before the end of the range.
+        auto c = cmp(*n.first, end);
+        if (end_inclusive ? c > 0 : c >= 0) {
+            return;
+        }
+        if (cmp(start, dht::ring_position_view::for_after_key(*n.last)) < 0) {
+            func(n.sst);
+        }
+        b = m + 1;
+    }
+}
+
+// O(n), like the copy of the set which precedes it.
+lw_shared_ptr<const sstable_interval_index> sstable_interval_index::insert(shared_sstable sst) const {
+    auto ret = make_lw_shared<sstable_interval_index>(*this);
+    auto* first = &sst->get_first_decorated_key();
+    auto* last = &sst->get_last_decorated_key();
+    dht::ring_position_less_comparator less(*_schema);
+    auto it = std::upper_bound(ret->_entries.begin(), ret->_entries.end(), first, [&less] (const dht::decorated_key* first, const entry& e) {
+        return less(*first, *e.first);
+    });
+    ret->_entries.insert(it, entry{std::move(sst), first, last, nullptr});
+    ret->build(0, ret->_entries.size());
+    return ret;
+}
+
+// O(n), like the copy of the set which precedes it.
+lw_shared_ptr<const sstable_interval_index> sstable_interval_index::erase(const shared_sstable& sst) const {
+    auto ret = make_lw_shared<sstable_interval_index>(*this);
+    auto e = std::remove_if(ret->_entries.begin(), ret->_entries.end(), [&sst] (const entry& e) { return e.sst == sst; });
+    ret->_entries.erase(e, ret->_entries.end());
+    ret->build(0, ret->_entries.size());
+    return ret;
+}
+
+std::vector<shared_sstable> sstable_interval_index::select(const dht::partition_range& range) const {
+    std::vector<shared_sstable> ret;
+    auto func = [&ret] (const shared_sstable& sst) { ret.push_back(sst); };
+    visit(0, _entries.size(), dht::ring_position_view::for_range_start(range), dht::ring_position_view::for_range_end(range), false, func);
+    return ret;
+}
+
+std::vector<shared_sstable> sstable_interval_index::select(dht::ring_position_view pos) const {
+    std::vector<shared_sstable> ret;
+    auto func = [&ret] (const shared_sstable& sst) { ret.push_back(sst); };
+    visit(0, _entries.size(), pos, pos, true, func);
+    return ret;
+}
+
+const dht::decorated_key* sstable_interval_index::next_first_key(dht::ring_position_view pos) const {
+    dht::ring_position_comparator cmp(*_schema);
+    auto it = std::upper_bound(_entries.begin(), _entries.end(), pos, [&cmp] (const dht::ring_position_view& p, const entry& e) {
+        return cmp(p, *e.first) < 0;
+    });
+    return it != _entries.end() ? it->first : nullptr;
+}
+
 partitioned_sstable_set::interval_type partitioned_sstable_set::make_interval(const schema& s, const dht::partition_range& range) {
     return interval_type::closed(
             compatible_ring_position_or_view(s, dht::ring_position_view(range.start()->value())),
@@ -212,21 +312,23 @@ dht::partition_range partitioned_sstable_set::to_partition_range(const interval_
             {to_ring_position(i.upper()), boost::icl::is_right_closed(i.bounds())});
 }
 
+dht::partition_range::bound partitioned_sstable_set::lower_bound(const dht::ring_position_view& pos) {
+    if (pos.key()) {
+        return dht::partition_range::bound(dht::ring_position(pos.token(), *pos.key()),
+                pos.is_after_key() == dht::ring_position_view::after_key::no);
+    } else {
+        return dht::partition_range::bound(dht::ring_position(pos.token(), pos.get_token_bound()), true);
+    }
+}
+
 dht::partition_range partitioned_sstable_set::to_partition_range(const dht::ring_position_view& pos, const interval_type& i) {
-    auto lower_bound = [&] {
-        if (pos.key()) {
-            return dht::partition_range::bound(dht::ring_position(pos.token(), *pos.key()),
-                    pos.is_after_key() == dht::ring_position_view::after_key::no);
-        } else {
-            return dht::partition_range::bound(dht::ring_position(pos.token(), pos.get_token_bound()), true);
-        }
-    }();
     auto upper_bound = dht::partition_range::bound(to_ring_position(i.lower()), !boost::icl::is_left_closed(i.bounds()));
-    return dht::partition_range::make(std::move(lower_bound), std::move(upper_bound));
+    return dht::partition_range::make(lower_bound(pos), std::move(upper_bound));
 }
 
 partitioned_sstable_set::partitioned_sstable_set(schema_ptr schema, lw_shared_ptr<sstable_list> all, bool use_level_metadata)
         : _schema(std::move(schema))
+        , _unleveled_sstables(make_lw_shared<const sstable_interval_index>(_schema, std::vector<shared_sstable>()))
         , _all(std::move(all))
         , _use_level_metadata(use_level_metadata) {
 }
@@ -243,7 +345,7 @@ std::vector<shared_sstable> partitioned_sstable_set::select(const dht::partition
     while (b != e) {
         boost::copy(b++->second, std::inserter(result, result.end()));
     }
-    auto r = _unleveled_sstables;
+    auto r = _unleveled_sstables->select(range);
     r.insert(r.end(), result.begin(), result.end());
     return r;
 }
@@ -262,7 +364,7 @@ void partitioned_sstable_set::insert(shared_sstable sst) {
     _all->insert(sst);
     try {
         if (store_as_unleveled(sst)) {
-            _unleveled_sstables.push_back(std::move(sst));
+            _unleveled_sstables = _unleveled_sstables->insert(std::move(sst));
         } else {
             _leveled_sstables_change_cnt++;
             _leveled_sstables.add({make_interval(*sst), value_set({sst})});
@@ -275,7 +377,7 @@ void partitioned_sstable_set::insert(shared_sstable sst) {
 void partitioned_sstable_set::erase(shared_sstable sst) {
     _all->erase(sst);
     if (store_as_unleveled(sst)) {
-        _unleveled_sstables.erase(std::remove(_unleveled_sstables.begin(), _unleveled_sstables.end(), sst), _unleveled_sstables.end());
+        _unleveled_sstables = _unleveled_sstables->erase(sst);
     } else {
         _leveled_sstables_change_cnt++;
         _leveled_sstables.subtract({make_interval(*sst), value_set({sst})});
@@ -284,7 +386,10 @@ void partitioned_sstable_set::erase(shared_sstable sst) {
 
 class partitioned_sstable_set::incremental_selector : public incremental_selector_impl {
     schema_ptr _schema;
-    const std::vector<shared_sstable>& _unleveled_sstables;
+    const lw_shared_ptr<const sstable_interval_index>& _unleveled_sstables;
+    // Snapshot of the unleveled sstables used by the last select(), which keeps
+    // alive the key backing the dht::ring_position_view it returned.
+    lw_shared_ptr<const sstable_interval_index> _unleveled_snapshot;
     const interval_map_type& _leveled_sstables;
     const uint64_t& _leveled_sstables_change_cnt;
     uint64_t _last_known_leveled_sstables_change_cnt;
@@ -314,36 +419,55 @@ class partitioned_sstable_set::incremental_selector : public incremental_selecto
             _last_known_leveled_sstables_change_cnt = _leveled_sstables_change_cnt;
         }
     }
-public:
-    incremental_selector(schema_ptr schema, const std::vector<shared_sstable>& unleveled_sstables, const interval_map_type& leveled_sstables,
-                         const uint64_t& leveled_sstables_change_cnt)
-        : _schema(std::move(schema))
-        , _unleveled_sstables(unleveled_sstables)
-        , _leveled_sstables(leveled_sstables)
-        , _leveled_sstables_change_cnt(leveled_sstables_change_cnt)
-        , _last_known_leveled_sstables_change_cnt(leveled_sstables_change_cnt)
-        , _it(leveled_sstables.begin())
-        , _next_position(dht::ring_position::min()) {
-    }
-    virtual std::tuple<dht::partition_range, std::vector<shared_sstable>, dht::ring_position_view> select(const dht::ring_position_view& pos) override {
+    std::tuple<dht::partition_range, std::vector<shared_sstable>, dht::ring_position_view> select_leveled(const dht::ring_position_view& pos) {
         auto crp = compatible_ring_position_or_view(*_schema, pos);
-        auto ssts = _unleveled_sstables;
         using namespace dht;
 
         maybe_invalidate_iterator(crp);
 
         while (_it != _leveled_sstables.end()) {
             if (boost::icl::contains(_it->first, crp)) {
-                ssts.insert(ssts.end(), _it->second.begin(), _it->second.end());
+                auto ssts = boost::copy_range<std::vector<shared_sstable>>(_it->second);
                 return std::make_tuple(partitioned_sstable_set::to_partition_range(_it->first), std::move(ssts), next_position(std::next(_it)));
             }
             // We don't want to skip current interval if pos lies before it.
             if (is_before_interval(crp, _it->first)) {
-                return std::make_tuple(partitioned_sstable_set::to_partition_range(pos, _it->first), std::move(ssts), next_position(_it));
+                return std::make_tuple(partitioned_sstable_set::to_partition_range(pos, _it->first), std::vector<shared_sstable>(), next_position(_it));
             }
             _it++;
         }
-        return std::make_tuple(partition_range::make_open_ended_both_sides(), std::move(ssts), ring_position_view::max());
+        return std::make_tuple(partition_range::make_open_ended_both_sides(), std::vector<shared_sstable>(), ring_position_view::max());
+    }
+public:
+    incremental_selector(schema_ptr schema, const lw_shared_ptr<const sstable_interval_index>& unleveled_sstables, const interval_map_type& leveled_sstables,
+                         const uint64_t& leveled_sstables_change_cnt)
+        : _schema(std::move(schema))
+        , _unleveled_sstables(unleveled_sstables)
+        , _leveled_sstables(leveled_sstables)
+        , _leveled_sstables_change_cnt(leveled_sstables_change_cnt)
+        , _last_known_leveled_sstables_change_cnt(leveled_sstables_change_cnt)
+        , _it(leveled_sstables.begin())
+        , _next_position(dht::ring_position::min()) {
+    }
+    virtual std::tuple<dht::partition_range, std::vector<shared_sstable>, dht::ring_position_view> select(const dht::ring_position_view& pos) override {
+        auto [range, ssts, next] = select_leveled(pos);
+        _unleveled_snapshot = _unleveled_sstables;
+        if (_unleveled_snapshot->empty()) {
+            return std::make_tuple(std::move(range), std::move(ssts), next);
+        }
+
+        // The unleveled sstables containing pos are all those which can contain
+        // a position in [pos, next first key of an unleveled sstable), so the
+        // selection is narrowed down to that range.
+        auto unleveled = _unleveled_snapshot->select(pos);
+        ssts.insert(ssts.end(), std::make_move_iterator(unleveled.begin()), std::make_move_iterator(unleveled.end()));
+        auto start = partitioned_sstable_set::lower_bound(pos);
+        auto* next_first_key = _unleveled_snapshot->next_first_key(pos);
+        if (next_first_key && dht::ring_position_tri_compare(*_schema, *next_first_key, next) < 0) {
+            auto end = dht::partition_range::bound(dht::ring_position(*next_first_key), false);
+            return std::make_tuple(dht::partition_range::make(std::move(start), std::move(end)), std::move(ssts), dht::ring_position_view(*next_first_key));
+        }
+        return std::make_tuple(dht::partition_range(std::move(start), range.end()), std::move(ssts), next);
     }
 };
 
@@ -862,9 +986,10 @@ sstable_set::make_local_shard_sstable_reader(
         tracing::trace_state_ptr trace_state,
         streamed_mutation::forwarding fwd,
         mutation_reader::forwarding fwd_mr,
-        read_monitor_generator& monitor_generator) const
+        read_monitor_generator& monitor_generator,
+        sstable_reader_wrapper wrapper) const
 {
-    auto reader_factory_fn = [s, permit, &slice, &pc, trace_state, fwd, fwd_mr, &monitor_generator]
+    auto reader_factory_fn = [s, permit, &slice, &pc, trace_state, fwd, fwd_mr, &monitor_generator, wrapper = std::move(wrapper)]
             (shared_sstable& sst, const dht::partition_range& pr) mutable {
         flat_mutation_reader reader = sst->make_reader(s, permit, pr, slice, pc,
                 trace_state, fwd, fwd_mr, monitor_generator(sst));
@@ -874,6 +999,9 @@ sstable_set::make_local_shard_sstable_reader(
             };
             reader = make_filtering_reader(std::move(reader), std::move(filter));
         }
+        if (wrapper) {
+            reader = wrapper(sst, std::move(reader));
+        }
         return reader;
     };
     return make_combined_reader(s, std::move(permit), std::make_unique<incremental_reader_selector>(s,
@@ -37,6 +37,10 @@ namespace sstables {
 class sstable_set_impl;
 class incremental_selector_impl;
 
+// Wraps the reader of a single sstable of a set, before it's merged with the
+// readers of the other sstables.
+using sstable_reader_wrapper = std::function<flat_mutation_reader(const shared_sstable&, flat_mutation_reader)>;
+
 // Structure holds all sstables (a.k.a. fragments) that belong to same run identifier, which is an UUID.
 // SStables in that same run will not overlap with one another.
 class sstable_run {
@@ -134,6 +138,7 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         read_monitor_generator& rmg = default_read_monitor_generator()) const;
 
     // Filters out mutations that don't belong to the current shard.
+    // If set, wrapper is applied to the reader of every sstable.
     flat_mutation_reader make_local_shard_sstable_reader(
         schema_ptr,
         reader_permit,
@@ -143,7 +148,8 @@ class sstable_set : public enable_lw_shared_from_this<sstable_set> {
         tracing::trace_state_ptr,
         streamed_mutation::forwarding,
         mutation_reader::forwarding,
-        read_monitor_generator& rmg = default_read_monitor_generator()) const;
+        read_monitor_generator& rmg = default_read_monitor_generator(),
+        sstable_reader_wrapper wrapper = {}) const;
 
     flat_mutation_reader make_reader(
             schema_ptr,
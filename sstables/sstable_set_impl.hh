@@ -58,6 +58,54 @@ class sstable_set_impl {
         mutation_reader::forwarding) const;
 };
 
+// Immutable index of sstables by token range, for overlap queries over sets
+// of sstables which overlap each other, e.g. level 0 of LCS or all of STCS.
+//
+// Entries are sorted by first key, and the sorted array doubles as a static,
+// balanced interval tree: the root of any sub-array [b, e) is its middle
+// entry, which also stores the largest last key of the sub-array. A query
+// skips every sub-tree ending before the queried range and stops at the first
+// entry starting after it, costing O(log n + k) comparisons instead of O(n),
+// without any per-node allocation.
+//
+// Changes build a new index (copy-on-write), so that copies of a set, which
+// are made on every sstable list update, share it and readers can hold on to
+// a consistent snapshot.
+class sstable_interval_index {
+    struct entry {
+        shared_sstable sst;
+        const dht::decorated_key* first;
+        const dht::decorated_key* last;
+        // Largest last key of the sub-tree rooted at this entry.
+        const dht::decorated_key* max_last;
+    };
+    schema_ptr _schema;
+    std::vector<entry> _entries;
+private:
+    const dht::decorated_key* build(size_t b, size_t e);
+    template <typename Func>
+    void visit(size_t b, size_t e, dht::ring_position_view start, dht::ring_position_view end, bool end_inclusive, Func& func) const;
+public:
+    sstable_interval_index(schema_ptr schema, std::vector<shared_sstable> sstables);
+
+    lw_shared_ptr<const sstable_interval_index> insert(shared_sstable sst) const;
+    lw_shared_ptr<const sstable_interval_index> erase(const shared_sstable& sst) const;
+
+    // sstables overlapping the range.
+    std::vector<shared_sstable> select(const dht::partition_range& range) const;
+    // sstables containing the position.
+    std::vector<shared_sstable> select(dht::ring_position_view pos) const;
+    // First key of the first sstable starting after the position, if any.
+    const dht::decorated_key* next_first_key(dht::ring_position_view pos) const;
+
+    size_t size() const {
+        return _entries.size();
+    }
+    bool empty() const {
+        return _entries.empty();
+    }
+};
+
 // specialized when sstables are partitioned in the token range space
 // e.g. leveled compaction strategy
 class partitioned_sstable_set : public sstable_set_impl {
@@ -67,7 +115,7 @@ class partitioned_sstable_set : public sstable_set_impl {
     using map_iterator = interval_map_type::const_iterator;
 private:
     schema_ptr _schema;
-    std::vector<shared_sstable> _unleveled_sstables;
+    lw_shared_ptr<const sstable_interval_index> _unleveled_sstables;
     interval_map_type _leveled_sstables;
     lw_shared_ptr<sstable_list> _all;
     // Change counter on interval map for leveled sstables which is used by
@@ -87,6 +135,8 @@ class partitioned_sstable_set : public sstable_set_impl {
     static dht::ring_position to_ring_position(const compatible_ring_position_or_view& crp);
     static dht::partition_range to_partition_range(const interval_type& i);
     static dht::partition_range to_partition_range(const dht::ring_position_view& pos, const interval_type& i);
+    // Bound of a range starting at pos.
+    static dht::partition_range::bound lower_bound(const dht::ring_position_view& pos);
     explicit partitioned_sstable_set(schema_ptr schema, lw_shared_ptr<sstable_list> all, bool use_level_metadata = true);
 
     virtual std::unique_ptr<sstable_set_impl> clone() const override;
@@ -71,6 +71,7 @@ const sstable_version_constants::component_map_t sstable_version_constants_k_l::
 const sstable_version_constants::component_map_t sstable_version_constants_m::create_component_map() {
     auto result = sstable_version_constants::create_component_map();
     result.emplace(component_type::Digest, "Digest.crc32");
+    result.emplace(component_type::Partitions, "Partitions.db");
     return result;
 }
 
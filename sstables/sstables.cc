@@ -75,6 +75,8 @@
 #include "utils/UUID_gen.hh"
 #include "database.hh"
 #include "sstables_manager.hh"
+#include "promoted_index_cache.hh"
+#include "write_tracking_file_impl.hh"
 #include <boost/algorithm/string/predicate.hpp>
 #include "tracing/traced_file.hh"
 #include "kl/reader.hh"
@@ -517,6 +519,9 @@ void write(sstable_version_types v, file_writer& out, const disk_set_of_tagged_u
     }
 }
 
+// Size of the pieces in which the entries of the Summary are read.
+static constexpr size_t summary_read_size = 128 * 1024;
+
 future<> parse(const schema& schema, sstable_version_types v, random_access_reader& in, summary& s) {
     using pos_type = typename decltype(summary::positions)::value_type;
 
@@ -544,6 +549,19 @@ future<> parse(const schema& schema, sstable_version_types v, random_access_read
                 // can guarantee that no conditionals are used, and we can always
                 // query the position of the "next" index.
                 s.positions.push_back(s.header.memory_size);
+                // The entries are read in the order of their positions, up to
+                // memory_size, so a position out of order or past memory_size
+                // would leave an entry which can never be completed.
+                for (size_t i = 0; i < s.header.size; ++i) {
+                    if (s.positions[i] > s.header.memory_size) {
+                        throw malformed_sstable_exception(format("invalid summary entry {}: position {} is past memory_size {}",
+                                i, s.positions[i], s.header.memory_size));
+                    }
+                    if (i > 0 && s.positions[i] < s.positions[i - 1]) {
+                        throw malformed_sstable_exception(format("invalid summary entry {}: position {} precedes position {} of the previous entry",
+                                i, s.positions[i], s.positions[i - 1]));
+                    }
+                }
                 return make_ready_future<>();
             });
         }).then([&in, &s] {
@@ -555,25 +573,49 @@ future<> parse(const schema& schema, sstable_version_types v, random_access_read
         }).then([&schema, &in, &s] {
             s.entries.reserve(s.header.size);
 
-            return do_with(int(0), [&schema, &in, &s] (int& idx) mutable {
-                return do_until([&s] { return s.entries.size() == s.header.size; }, [&schema, &s, &in, &idx] () mutable {
-                    auto pos = s.positions[idx++];
-                    auto next = s.positions[idx];
-
-                    auto entrysize = next - pos;
-                    return in.read_exactly(entrysize).then([&schema, &s, entrysize] (auto buf) mutable {
-                        check_buf_size(buf, entrysize);
-
-                        auto keysize = entrysize - 8;
-                        auto key_data = s.add_summary_data(bytes_view(reinterpret_cast<const int8_t*>(buf.get()), keysize));
-                        buf.trim_front(keysize);
+            // The entries are read in large pieces and decoded in place, rather
+            // than read one by one. An entry which straddles two pieces is
+            // carried over and completed by the next one.
+            return do_with(size_t(0), temporary_buffer<char>(), [&schema, &in, &s] (size_t& idx, temporary_buffer<char>& carry) mutable {
+                return do_until([&s] { return s.entries.size() == s.header.size; }, [&schema, &s, &in, &idx, &carry] () mutable {
+                    auto unread = s.header.memory_size - (s.positions[idx] + carry.size());
+                    auto len = std::min(unread, uint64_t(summary_read_size));
+                    if (len == 0) {
+                        return make_exception_future<>(malformed_sstable_exception(format("invalid summary entry {}: incomplete at the end of the summary, memory_size is {}",
+                                idx, s.header.memory_size)));
+                    }
+                    return in.read_exactly(len).then([&schema, &s, &idx, &carry, len] (temporary_buffer<char> buf) mutable {
+                        check_buf_size(buf, len);
+                        if (!carry.empty()) {
+                            temporary_buffer<char> joined(carry.size() + buf.size());
+                            std::copy_n(carry.get(), carry.size(), joined.get_write());
+                            std::copy_n(buf.get(), buf.size(), joined.get_write() + carry.size());
+                            buf = std::move(joined);
+                        }
+
+                        size_t offset = 0;
+                        while (idx < s.header.size) {
+                            auto pos = s.positions[idx];
+                            auto next = s.positions[idx + 1];
+                            if (next < pos + sizeof(uint64_t)) {
+                                throw malformed_sstable_exception(format("invalid summary entry {}: positions {} and {}", idx, pos, next));
+                            }
+                            auto entrysize = next - pos;
+                            if (offset + entrysize > buf.size()) {
+                                break;
+                            }
 
-                        // position is little-endian encoded
-                        auto position = seastar::read_le<uint64_t>(buf.get());
-                        auto token = schema.get_partitioner().get_token(key_view(key_data));
-                        s.add_summary_data(token.data());
-                        s.entries.push_back({ token, key_data, position });
-                        return make_ready_future<>();
+                            auto keysize = entrysize - 8;
+                            auto key_data = bytes_view(reinterpret_cast<const int8_t*>(buf.get() + offset), keysize);
+                            // position is little-endian encoded
+                            auto position = seastar::read_le<uint64_t>(buf.get() + offset + keysize);
+                            auto token = schema.get_partitioner().get_token(key_view(key_data));
+                            s.entries.push_back(token, key_data, position);
+                            offset += entrysize;
+                            idx++;
+                        }
+                        buf.trim_front(offset);
+                        carry = std::move(buf);
                     });
                 });
             }).then([&s] {
@@ -584,6 +626,25 @@ future<> parse(const schema& schema, sstable_version_types v, random_access_read
     });
 }
 
+// The header and the first and last keys of a Summary, without its positions and entries.
+struct summary_bounds {
+    summary& s;
+};
+
+future<> parse(const schema& schema, sstable_version_types v, random_access_reader& in, summary_bounds& b) {
+    auto& s = b.s;
+    return parse(schema, v, in, s.header.min_index_interval,
+                     s.header.size,
+                     s.header.memory_size,
+                     s.header.sampling_level,
+                     s.header.size_at_full_sampling).then([v, &schema, &in, &s] {
+        // The keys follow the positions and the entries, whose total size is memory_size.
+        return in.seek(sizeof(summary::header) + s.header.memory_size).then([v, &schema, &in, &s] {
+            return parse(schema, v, in, s.first_key, s.last_key);
+        });
+    });
+}
+
 inline void write(sstable_version_types v, file_writer& out, const summary_entry& entry) {
     // FIXME: summary entry is supposedly written in memory order, but that
     // would prevent portability of summary file between machines of different
@@ -604,17 +665,19 @@ inline void write(sstable_version_types v, file_writer& out, const summary& s) {
         auto p = seastar::cpu_to_le(e);
         out.write(reinterpret_cast<const char*>(&p), sizeof(p));
     }
-    write(v, out, s.entries);
+    for (auto&& e : s.entries) {
+        write(v, out, e);
+    }
     write(v, out, s.first_key, s.last_key);
 }
 
-future<summary_entry&> sstable::read_summary_entry(size_t i) {
+future<summary_entry> sstable::read_summary_entry(size_t i) {
     // The last one is the boundary marker
     if (i >= (_components->summary.entries.size())) {
         throw std::out_of_range(format("Invalid Summary index: {:d}", i));
     }
 
-    return make_ready_future<summary_entry&>(_components->summary.entries[i]);
+    return make_ready_future<summary_entry>(_components->summary.entries[i]);
 }
 
 future<> parse(const schema& s, sstable_version_types v, random_access_reader& in, deletion_time& d) {
@@ -1296,6 +1359,20 @@ future<> sstable::read_summary(const io_priority_class& pc) noexcept {
     });
 }
 
+future<> sstable::read_summary_bounds(const io_priority_class& pc) noexcept {
+    return read_toc().then([this, &pc] {
+        if (!has_component(component_type::Summary)) {
+            return read_summary(pc);
+        }
+        return do_with(summary_bounds{_components->summary}, [this, &pc] (summary_bounds& b) {
+            return read_simple<component_type::Summary>(b, pc);
+        }).handle_exception([this, &pc] (auto ep) {
+            sstlog.warn("Couldn't read the bounds of summary file {}: {}. Reading it whole.", this->filename(component_type::Summary), ep);
+            return read_summary(pc);
+        });
+    });
+}
+
 future<file> sstable::open_file(component_type type, open_flags flags, file_open_options opts) noexcept {
     return new_sstable_component_file(_read_error_handler, type, flags, opts);
 }
@@ -1352,6 +1429,16 @@ future<> sstable::update_info_for_opened_data() {
         return _index_file.size().then([this] (auto size) {
             _index_file_size = size;
         });
+    }).then([this] {
+        if (!has_partition_trie()) {
+            return make_ready_future<>();
+        }
+        return open_file(component_type::Partitions, open_flags::ro).then([this] (file f) {
+            _partitions_file = std::move(f);
+            return _partitions_file.size();
+        }).then([this] (uint64_t size) {
+            _partitions_file_size = size;
+        });
     }).then([this] {
         if (this->has_component(component_type::Filter)) {
             return io_check([&] {
@@ -1425,17 +1512,30 @@ void sstable::write_filter(const io_priority_class& pc) {
 // This interface is only used during tests, snapshot loading and early initialization.
 // No need to set tunable priorities for it.
 future<> sstable::load(const io_priority_class& pc) noexcept {
-    return read_toc().then([this, &pc] {
+    return load(pc, defer_components::no);
+}
+
+future<> sstable::load(const io_priority_class& pc, defer_components defer) noexcept {
+    return read_toc().then([this, &pc, defer] {
         // read scylla-meta after toc. Might need it to parse
         // rest (hint extensions)
-        return read_scylla_metadata(pc).then([this, &pc] {
+        return read_scylla_metadata(pc).then([this, &pc, defer] {
             // Read statistics ahead of others - if summary is missing
             // we'll attempt to re-generate it and we need statistics for that
-            return read_statistics(pc).then([this, &pc] {
+            return read_statistics(pc).then([this, &pc, defer] {
+                auto read_filter_and_summary = [this, &pc, defer] {
+                    if (!defer) {
+                        return seastar::when_all_succeed(read_filter(pc), read_summary(pc)).discard_result();
+                    }
+                    _components->filter = std::make_unique<utils::filter::always_present_filter>();
+                    _components_deferred = true;
+                    return read_summary_bounds(pc).then([this] {
+                        _manager.queue_deferred_load(*this);
+                    });
+                };
                 return seastar::when_all_succeed(
                         read_compression(pc),
-                        read_filter(pc),
-                        read_summary(pc)).then_unpack([this] {
+                        read_filter_and_summary()).then_unpack([this] {
                             validate_min_max_metadata();
                             validate_max_local_deletion_time();
                             validate_partitioner();
@@ -1460,11 +1560,54 @@ future<> sstable::load(sstables::foreign_sstable_open_info info) noexcept {
     });
 }
 
+future<> sstable::start_deferred_components_load(const io_priority_class& pc) {
+    if (!_deferred_components_load) {
+        // The load may outlive the access which started it.
+        auto f = seastar::async([this, pc] {
+            // Load the Summary aside, so that it's never seen partially loaded.
+            if (!_components->summary) {
+                summary s;
+                try {
+                    read_simple<component_type::Summary>(s, pc).get();
+                    _components->summary = std::move(s);
+                } catch (...) {
+                    sstlog.warn("Couldn't read summary file {}: {}. Recreating it.", filename(component_type::Summary), std::current_exception());
+                    generate_summary(pc).get();
+                }
+            }
+            read_filter(pc).get();
+            _components_deferred = false;
+        }).handle_exception([this, self = shared_from_this()] (std::exception_ptr ep) {
+            // Let the next access retry.
+            _deferred_components_load.reset();
+            return make_exception_future<>(std::move(ep));
+        });
+        _deferred_components_load.emplace(std::move(f));
+    }
+    return _deferred_components_load->get_future();
+}
+
+future<> sstable::load_deferred_components(const io_priority_class& pc) noexcept {
+    if (!_components_deferred) {
+        return make_ready_future<>();
+    }
+    if (_deferred_components_load) {
+        return _deferred_components_load->get_future();
+    }
+    auto start = std::chrono::steady_clock::now();
+    return futurize_invoke([this, &pc] {
+        return start_deferred_components_load(pc);
+    }).then([this, start] {
+        _stats.on_deferred_components_load_on_access(std::chrono::steady_clock::now() - start);
+    });
+}
+
 future<foreign_sstable_open_info> sstable::get_open_info() & {
-    return _components.copy().then([this] (auto c) mutable {
-        return foreign_sstable_open_info{std::move(c), this->get_shards_for_this_sstable(), _data_file.dup(), _index_file.dup(),
+    // The components are shared with the other shard as they are, so they must be complete.
+    co_await load_deferred_components(default_priority_class());
+    auto c = co_await _components.copy();
+    co_return foreign_sstable_open_info{std::move(c), get_shards_for_this_sstable(), _data_file.dup(), _index_file.dup(),
             _generation, _version, _format, data_size()};
-    });
 }
 
 void prepare_summary(summary& s, uint64_t expected_partition_count, uint32_t min_index_interval) {
@@ -1502,7 +1645,7 @@ future<> seal_summary(summary& s,
 
     s.header.memory_size = s.header.size * sizeof(uint32_t);
     s.positions.reserve(s.entries.size());
-    return do_for_each(s.entries, [&s] (summary_entry& e) {
+    return do_for_each(s.entries, [&s] (const summary_entry& e) {
         s.positions.push_back(s.header.memory_size);
         s.header.memory_size += e.key.size() + sizeof(e.position);
     });
@@ -1584,9 +1727,7 @@ void maybe_add_summary_entry(summary& s, const dht::token& token, bytes_view key
     if (data_offset >= state.next_data_offset_to_write_summary) {
         auto entry_size = 8 + 2 + key.size();  // offset + key_size.size + key.size
         state.next_data_offset_to_write_summary += state.summary_byte_cost * entry_size;
-        s.add_summary_data(token.data());
-        auto key_data = s.add_summary_data(key);
-        s.entries.push_back({ token, key_data, index_offset });
+        s.entries.push_back(token, key, index_offset);
     }
 }
 
@@ -2322,7 +2463,17 @@ int sstable::compare_by_max_timestamp(const sstable& other) const {
     return (ts1 > ts2 ? 1 : (ts1 == ts2 ? 0 : -1));
 }
 
+partition_trie_reader& sstable::get_partition_trie() {
+    if (!_partition_trie) {
+        _partition_trie.emplace(_partitions_file, _partitions_file_size,
+                _manager.make_shared_cache_permit(_schema.get(), "partition-trie"), index_page_cache_metrics,
+                size_t(_manager.config().sstable_partition_trie_cache_size_in_kb()) * 1024, filename(component_type::Partitions));
+    }
+    return *_partition_trie;
+}
+
 future<> sstable::close_files() {
+    _partition_trie.reset();
     auto index_closed = make_ready_future<>();
     if (_index_file) {
         index_closed = _index_file.close().handle_exception([me = shared_from_this()] (auto ep) {
@@ -2338,6 +2489,14 @@ future<> sstable::close_files() {
         });
     }
 
+    auto partitions_closed = make_ready_future<>();
+    if (_partitions_file) {
+        partitions_closed = _partitions_file.close().handle_exception([me = shared_from_this()] (auto ep) {
+            sstlog.warn("sstable close partitions_file failed: {}", ep);
+            general_disk_error();
+        });
+    }
+
     auto unlinked = make_ready_future<>();
     if (_marked_for_deletion != mark_for_deletion::none) {
         // If a deletion fails for some reason we
@@ -2362,7 +2521,7 @@ future<> sstable::close_files() {
 
     _on_closed(*this);
 
-    return when_all_succeed(std::move(index_closed), std::move(data_closed), std::move(unlinked)).discard_result();
+    return when_all_succeed(std::move(index_closed), std::move(data_closed), std::move(partitions_closed), std::move(unlinked)).discard_result();
 }
 
 static inline sstring dirname(const sstring& fname) {
@@ -2588,8 +2747,11 @@ std::optional<std::pair<uint64_t, uint64_t>> sstable::get_index_pages_for_range(
 }
 
 std::vector<dht::decorated_key> sstable::get_key_samples(const schema& s, const dht::token_range& range) {
-    auto index_range = get_sample_indexes_for_range(range);
     std::vector<dht::decorated_key> res;
+    if (_components_deferred) {
+        return res;
+    }
+    auto index_range = get_sample_indexes_for_range(range);
     if (index_range) {
         for (auto idx = index_range->first; idx < index_range->second; ++idx) {
             auto pkey = _components->summary.entries[idx].get_key().to_partition_key(s);
@@ -2600,6 +2762,24 @@ std::vector<dht::decorated_key> sstable::get_key_samples(const schema& s, const
 }
 
 uint64_t sstable::estimated_keys_for_range(const dht::token_range& range) {
+    if (_components_deferred) {
+        // Without the Summary entries, assume keys are spread evenly between the first and last tokens.
+        auto first = get_first_decorated_key().token();
+        auto last = get_last_decorated_key().token();
+        auto overlap = dht::token_range::make(first, last).intersection(range, dht::token_comparator());
+        if (!overlap) {
+            return 0;
+        }
+        if (first == last) {
+            return get_estimated_key_count();
+        }
+        auto span = [] (const dht::token& a, const dht::token& b) {
+            return static_cast<long double>(b.raw()) - static_cast<long double>(a.raw());
+        };
+        auto start = overlap->start() ? overlap->start()->value() : first;
+        auto end = overlap->end() ? overlap->end()->value() : last;
+        return std::max(uint64_t(1), uint64_t(get_estimated_key_count() * span(start, end) / span(first, last)));
+    }
     auto page_range = get_index_pages_for_range(range);
     if (!page_range) {
         return 0;
@@ -2649,12 +2829,14 @@ future<bool> sstable::has_partition_key(const utils::hashed_key& hk, const dht::
     if (!filter_has_key(hk)) {
         return make_ready_future<bool>(false);
     }
-    auto sem = std::make_unique<reader_concurrency_semaphore>(reader_concurrency_semaphore::no_limits{});
-    auto lh_index_ptr = std::make_unique<sstables::index_reader>(s, sem->make_permit(_schema.get(), s->get_filename()), default_priority_class(), tracing::trace_state_ptr());
-    auto& lh_index = *lh_index_ptr;
-    return lh_index.advance_lower_and_check_if_present(dk).then([lh_index_ptr = std::move(lh_index_ptr), s, sem = std::move(sem)] (bool present) mutable {
-        lh_index_ptr.reset(); // destroy before the semaphore
-        return make_ready_future<bool>(present);
+    return load_deferred_components(default_priority_class()).then([this, s, &dk] {
+        auto sem = std::make_unique<reader_concurrency_semaphore>(reader_concurrency_semaphore::no_limits{});
+        auto lh_index_ptr = std::make_unique<sstables::index_reader>(s, sem->make_permit(_schema.get(), s->get_filename()), default_priority_class(), tracing::trace_state_ptr());
+        auto& lh_index = *lh_index_ptr;
+        return lh_index.advance_lower_and_check_if_present(dk).then([lh_index_ptr = std::move(lh_index_ptr), s, sem = std::move(sem)] (bool present) mutable {
+            lh_index_ptr.reset(); // destroy before the semaphore
+            return make_ready_future<bool>(present);
+        });
     });
 }
 
@@ -2805,6 +2987,7 @@ thread_local sstables_stats::stats sstables_stats::_shard_stats;
 thread_local shared_index_lists::stats shared_index_lists::_shard_stats;
 thread_local cached_file::metrics index_page_cache_metrics;
 thread_local mc::cached_promoted_index::metrics promoted_index_cache_metrics;
+thread_local promoted_index_cache::stats promoted_index_cache_stats;
 static thread_local seastar::metrics::metric_groups metrics;
 
 future<> init_metrics() {
@@ -2849,6 +3032,29 @@ future<> init_metrics() {
             sm::description("Number of bytes currently used by cached promoted index blocks")),
         sm::make_gauge("pi_cache_block_count", [] { return promoted_index_cache_metrics.block_count; },
             sm::description("Number of promoted index blocks currently cached")),
+        sm::make_derive("pi_cache_partition_hits", [] { return promoted_index_cache_stats.hits; },
+            sm::description("Number of reads of a wide partition which reused the promoted index blocks parsed by earlier reads")),
+        sm::make_derive("pi_cache_partition_misses", [] { return promoted_index_cache_stats.misses; },
+            sm::description("Number of reads of a wide partition whose promoted index blocks weren't kept from earlier reads")),
+        sm::make_derive("pi_cache_partition_evictions", [] { return promoted_index_cache_stats.evictions; },
+            sm::description("Number of wide partitions whose promoted index blocks were dropped from the shared cache")),
+        sm::make_gauge("pi_cache_partitions", [] { return promoted_index_cache_stats.entries; },
+            sm::description("Number of wide partitions whose promoted index blocks are kept across reads")),
+        sm::make_gauge("pi_cache_shared_bytes", [] { return promoted_index_cache_stats.used_bytes; },
+            sm::description("Number of bytes used by promoted index blocks shared across reads")),
+
+        sm::make_derive("data_write_bytes", [] { return shard_data_write_stats().throughput.bytes(); },
+            sm::description("Number of bytes written to the Data component of sstables")),
+        sm::make_derive("data_writes", [] { return shard_data_write_stats().throughput.writes(); },
+            sm::description("Number of writes to the Data component of sstables")),
+        sm::make_derive("data_write_busy_time", [] {
+                return std::chrono::duration_cast<std::chrono::microseconds>(shard_data_write_stats().throughput.busy_time()).count();
+            },
+            sm::description("Time in microseconds spent with writes to the Data component of sstables in flight; data_write_bytes over it is the achieved write throughput")),
+        sm::make_gauge("data_writes_in_flight", [] { return shard_data_write_stats().throughput.in_flight(); },
+            sm::description("Number of writes to the Data component of sstables currently in flight")),
+        sm::make_gauge("last_data_write_throughput", [] { return shard_data_write_stats().last_writer_throughput; },
+            sm::description("Bytes per second written to the Data component by the last sstable writer which finished, while it had writes in flight")),
 
         sm::make_derive("partition_writes", [] { return sstables_stats::get_shard_stats().partition_writes; },
             sm::description("Number of partitions written")),
@@ -2879,6 +3085,20 @@ future<> init_metrics() {
             sm::description("Was local deletion time capped at maximum allowed value in Statistics")),
         sm::make_counter("capped_tombstone_deletion_time", [] { return sstables_stats::get_shard_stats().capped_tombstone_deletion_time; },
             sm::description("Was partition tombstone deletion time capped at maximum allowed value")),
+        sm::make_derive("deferred_component_loads_on_access", [] { return sstables_stats::get_shard_stats().deferred_component_loads_on_access; },
+            sm::description("Number of sstables whose deferred Summary and Filter were loaded by a read waiting for them")),
+        sm::make_derive("deferred_component_loads_in_background", [] { return sstables_stats::get_shard_stats().deferred_component_loads_in_background; },
+            sm::description("Number of sstables whose deferred Summary and Filter were loaded in the background")),
+        sm::make_derive("deferred_component_load_on_access_us", [] { return sstables_stats::get_shard_stats().deferred_component_load_on_access_us; },
+            sm::description("Total time in microseconds reads spent waiting for deferred Summary and Filter to be loaded")),
+        sm::make_derive("directory_sstables_loaded", [] { return sstables_stats::get_shard_stats().directory_sstables_loaded; },
+            sm::description("Number of sstables loaded from table directories, e.g. on boot or on refresh")),
+        sm::make_derive("directory_listing_us", [] { return sstables_stats::get_shard_stats().directory_listing_us; },
+            sm::description("Total time in microseconds spent listing table directories to load sstables from")),
+        sm::make_derive("directory_loading_us", [] { return sstables_stats::get_shard_stats().directory_loading_us; },
+            sm::description("Total time in microseconds from the start of listing of table directories until their sstables were loaded")),
+        sm::make_derive("directory_sorting_us", [] { return sstables_stats::get_shard_stats().directory_sorting_us; },
+            sm::description("Total time in microseconds spent sorting the loaded sstables of table directories by owning shard")),
     });
   });
 }
@@ -2958,6 +3178,7 @@ std::ostream& operator<<(std::ostream& out, const sstables::component_type& comp
     case ct::TemporaryTOC: out << "TemporaryTOC"; break;
     case ct::TemporaryStatistics: out << "TemporaryStatistics"; break;
     case ct::Scylla: out << "Scylla"; break;
+    case ct::Partitions: out << "Partitions"; break;
     case ct::Unknown: out << "Unknown"; break;
     }
     return out;
@@ -61,10 +61,12 @@
 #include "utils/observable.hh"
 #include "sstables/shareable_components.hh"
 #include "sstables/open_info.hh"
+#include "sstables/partition_trie.hh"
 #include "query-request.hh"
 #include "mutation_fragment_stream_validator.hh"
 
 #include <seastar/util/optimized_optional.hh>
+#include <seastar/core/shared_future.hh>
 #include <boost/intrusive/list.hpp>
 
 class sstable_assertions;
@@ -108,6 +110,8 @@ extern bool use_binary_search_in_promoted_index;
 
 extern size_t summary_byte_cost(double summary_ratio);
 
+static constexpr size_t default_sstable_buffer_size = 128 * 1024;
+
 struct sstable_writer_config {
     size_t promoted_index_block_size;
     uint64_t max_sstable_size = std::numeric_limits<uint64_t>::max();
@@ -122,6 +126,11 @@ struct sstable_writer_config {
     utils::UUID run_identifier = utils::make_random_uuid();
     size_t summary_byte_cost;
     sstring origin;
+    // Write a Partitions component (mc and md only).
+    bool write_partition_trie = false;
+    // Size of the writes to the Data component, and amount of them in flight.
+    size_t data_write_buffer_size = default_sstable_buffer_size;
+    size_t data_write_in_flight_size = 2 * default_sstable_buffer_size;
 
 private:
     explicit sstable_writer_config() {}
@@ -138,6 +147,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     using format_types = sstable_format_types;
     using tracker_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
     using manager_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
+    using deferred_load_link_type = bi::list_member_hook<bi::link_mode<bi::auto_unlink>>;
 public:
     sstable(schema_ptr schema,
             sstring dir,
@@ -193,6 +203,18 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // this variant will be useful for testing purposes and also when loading
     // a new sstable from scratch for sharing its components.
     future<> load(const io_priority_class& pc = default_priority_class()) noexcept;
+    // With defer_components::yes, the Filter and the entries of the Summary are
+    // left out, so that opening the sstable only reads its TOC, Statistics,
+    // CompressionInfo and Scylla components and the bounds of its Summary.
+    // They are loaded by load_deferred_components(), on first access or by
+    // the background pass of the sstables_manager, whichever comes first.
+    future<> load(const io_priority_class& pc, defer_components defer) noexcept;
+    // Loads the components left out by load(), if any. Must be waited for
+    // before looking up the index.
+    future<> load_deferred_components(const io_priority_class& pc) noexcept;
+    bool has_deferred_components() const {
+        return _components_deferred;
+    }
     future<> open_data() noexcept;
     future<> update_info_for_opened_data();
 
@@ -285,6 +307,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     uint64_t index_size() const {
         return _index_file_size;
     }
+    uint64_t partitions_size() const {
+        return _partitions_file_size;
+    }
     uint64_t filter_size() const {
         return _filter_file_size;
     }
@@ -461,8 +486,12 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     std::set<int> _compaction_ancestors;
     file _index_file;
     file _data_file;
+    // Opened along with the data and index files, if the sstable has it.
+    file _partitions_file;
+    std::optional<partition_trie_reader> _partition_trie;
     uint64_t _data_file_size;
     uint64_t _index_file_size;
+    uint64_t _partitions_file_size = 0;
     uint64_t _filter_file_size = 0;
     uint64_t _bytes_on_disk = 0;
     db_clock::time_point _data_file_write_time;
@@ -505,6 +534,13 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     sstables_stats _stats;
     tracker_link_type _tracker_link;
     manager_link_type _manager_link;
+    deferred_load_link_type _deferred_load_link;
+
+    // Set while the Filter and the Summary entries are left out by load().
+    // Until they're loaded, the filter lets every key through, and the
+    // Summary holds only its header and the first and last keys.
+    bool _components_deferred = false;
+    std::optional<shared_future<>> _deferred_components_load;
 
     // The _large_data_stats map stores e.g. largest partitions, rows, cells sizes,
     // and max number of rows in a partition.
@@ -557,6 +593,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     void write_filter(const io_priority_class& pc);
 
     future<> read_summary(const io_priority_class& pc) noexcept;
+    // Reads only the header and the first and last keys of the Summary.
+    future<> read_summary_bounds(const io_priority_class& pc) noexcept;
+    future<> start_deferred_components_load(const io_priority_class& pc);
 
     void write_summary(const io_priority_class& pc) {
         write_simple<component_type::Summary>(_components->summary, pc);
@@ -610,7 +649,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // for iteration through all the rows.
     future<temporary_buffer<char>> data_read(uint64_t pos, size_t len, const io_priority_class& pc, reader_permit permit);
 
-    future<summary_entry&> read_summary_entry(size_t i);
+    future<summary_entry> read_summary_entry(size_t i);
 
     // FIXME: pending on Bloom filter implementation
     bool filter_has_key(const schema& s, const dht::decorated_key& dk) { return filter_has_key(key::from_partition_key(s, dk._key)); }
@@ -649,6 +688,17 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return has_component(component_type::Scylla);
     }
 
+    // Whether the sstable has a Partitions component, which index_reader
+    // uses for point lookups instead of the Summary.
+    bool has_partition_trie() const {
+        return has_component(component_type::Partitions);
+    }
+
+    // Returns the reader of the Partitions component, created on first use.
+    // Its page cache is shared by all reads of the sstable.
+    // Must only be called when has_partition_trie().
+    partition_trie_reader& get_partition_trie();
+
     bool has_correct_promoted_index_entries() const {
         return _schema->is_compound() || !has_scylla_component() || _components->scylla_metadata->has_feature(sstable_feature::NonCompoundPIEntries);
     }
@@ -22,6 +22,7 @@
 #include "log.hh"
 #include "sstables/sstables_manager.hh"
 #include "sstables/sstables.hh"
+#include "sstables/promoted_index_cache.hh"
 #include "db/config.hh"
 #include "gms/feature.hh"
 #include "gms/feature_service.hh"
@@ -30,9 +31,14 @@ namespace sstables {
 
 logging::logger smlogger("sstables_manager");
 
+extern thread_local promoted_index_cache::stats promoted_index_cache_stats;
+
 sstables_manager::sstables_manager(
     db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat)
-    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat) {
+    : _large_data_handler(large_data_handler), _db_config(dbcfg), _features(feat)
+    , _promoted_index_cache(std::make_unique<promoted_index_cache>(promoted_index_cache_stats,
+            size_t(dbcfg.promoted_index_cache_size_in_mb()) * 1024 * 1024)) {
+    _deferred_loader = load_deferred_components_in_background();
 }
 
 sstables_manager::~sstables_manager() {
@@ -60,6 +66,9 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    cfg.write_partition_trie = _db_config.enable_sstable_partition_trie();
+    cfg.data_write_buffer_size = _db_config.sstable_write_buffer_size_in_kb() * 1024;
+    cfg.data_write_in_flight_size = _db_config.sstable_write_in_flight_size_in_kb() * 1024;
 
     cfg.correctly_serialize_non_compound_range_tombstones = true;
     cfg.correctly_serialize_static_compact_in_mc =
@@ -69,6 +78,10 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
     return cfg;
 }
 
+bool sstables_manager::defer_component_loading() const {
+    return _db_config.lazy_load_sstable_components();
+}
+
 void sstables_manager::add(sstable* sst) {
     _active.push_back(*sst);
 }
@@ -77,6 +90,8 @@ void sstables_manager::deactivate(sstable* sst) {
     // At this point, sst has a reference count of zero, since we got here from
     // lw_shared_ptr_deleter<sstables::sstable>::dispose().
     _active.erase(_active.iterator_to(*sst));
+    sst->_deferred_load_link.unlink();
+    _promoted_index_cache->invalidate(*sst);
     _undergoing_close.push_back(*sst);
     // guard against sstable::close_files() calling shared_from_this() and immediately destroying
     // the result, which will dispose of the sstable recursively
@@ -98,10 +113,42 @@ void sstables_manager::maybe_done() {
     }
 }
 
+void sstables_manager::queue_deferred_load(sstable& sst) {
+    if (!sst._deferred_load_link.is_linked()) {
+        _deferred.push_back(sst);
+        _deferred_cv.signal();
+    }
+}
+
+// Loads the deferred components of one sstable at a time, so that they're
+// all loaded shortly after startup without competing with it for I/O.
+future<> sstables_manager::load_deferred_components_in_background() {
+    while (!_closing) {
+        if (_deferred.empty()) {
+            co_await _deferred_cv.wait();
+            continue;
+        }
+        auto sst = _deferred.front().shared_from_this();
+        sst->_deferred_load_link.unlink();
+        // Sstables already loaded, or being loaded, by a read are accounted for by it.
+        if (!sst->has_deferred_components() || sst->_deferred_components_load) {
+            continue;
+        }
+        try {
+            co_await sst->start_deferred_components_load(default_priority_class());
+            sst->get_stats().on_deferred_components_load_in_background();
+        } catch (...) {
+            smlogger.warn("Failed to load deferred components of {}, leaving them to first access: {}", sst->get_filename(), std::current_exception());
+        }
+    }
+}
+
 future<> sstables_manager::close() {
     _closing = true;
+    _deferred_cv.signal();
+    co_await std::exchange(_deferred_loader, make_ready_future<>());
     maybe_done();
-    return _done.get_future();
+    co_await _done.get_future();
 }
 
 }   // namespace sstables
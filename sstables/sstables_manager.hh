@@ -24,6 +24,7 @@
 
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sharded.hh>
+#include <seastar/core/condition-variable.hh>
 
 #include "utils/disk-error-handler.hh"
 #include "gc_clock.hh"
@@ -33,6 +34,7 @@
 #include "sstables/sstables.hh"
 #include "sstables/version.hh"
 #include "sstables/component_type.hh"
+#include "reader_concurrency_semaphore.hh"
 
 #include <boost/intrusive/list.hpp>
 
@@ -47,15 +49,18 @@ namespace gms { class feature_service; }
 
 namespace sstables {
 
+class promoted_index_cache;
+
 using schema_ptr = lw_shared_ptr<const schema>;
 using shareable_components_ptr = lw_shared_ptr<shareable_components>;
 
-static constexpr size_t default_sstable_buffer_size = 128 * 1024;
-
 class sstables_manager {
     using list_type = boost::intrusive::list<sstable,
             boost::intrusive::member_hook<sstable, sstable::manager_link_type, &sstable::_manager_link>,
             boost::intrusive::constant_time_size<false>>;
+    using deferred_list_type = boost::intrusive::list<sstable,
+            boost::intrusive::member_hook<sstable, sstable::deferred_load_link_type, &sstable::_deferred_load_link>,
+            boost::intrusive::constant_time_size<false>>;
 private:
     db::large_data_handler& _large_data_handler;
     const db::config& _db_config;
@@ -72,6 +77,18 @@ class sstables_manager {
     list_type _undergoing_close;
     bool _closing = false;
     promise<> _done;
+
+    // Sstables opened with deferred components, waiting for the background
+    // pass to load them, in the order they were opened.
+    deferred_list_type _deferred;
+    condition_variable _deferred_cv;
+    future<> _deferred_loader = make_ready_future<>();
+
+    std::unique_ptr<promoted_index_cache> _promoted_index_cache;
+
+    // Admits nothing; tracks the memory of the caches which sstables keep
+    // across reads, and which therefore don't belong to any of them.
+    reader_concurrency_semaphore _shared_cache_semaphore{reader_concurrency_semaphore::no_limits{}, "sstables_manager shared caches"};
 public:
     explicit sstables_manager(db::large_data_handler& large_data_handler, const db::config& dbcfg, gms::feature_service& feat);
     ~sstables_manager();
@@ -89,9 +106,19 @@ class sstables_manager {
     sstable_writer_config configure_writer(sstring origin) const;
     const db::config& config() const { return _db_config; }
 
+    // Whether sstables opened from disk leave their Filter and Summary
+    // entries to be loaded on first access or in the background.
+    bool defer_component_loading() const;
+
     void set_format(sstable_version_types format) { _format = format; }
     sstables::sstable::version_types get_highest_supported_format() const { return _format; }
 
+    promoted_index_cache& get_promoted_index_cache() { return *_promoted_index_cache; }
+
+    reader_permit make_shared_cache_permit(const schema* s, const char* op_name) {
+        return _shared_cache_semaphore.make_permit(s, op_name);
+    }
+
     // Wait until all sstables managed by this sstables_manager instance
     // (previously created by make_sstable()) have been disposed of:
     //   - if they were marked for deletion, the files are deleted
@@ -109,6 +136,9 @@ class sstables_manager {
     void deactivate(sstable* sst);
     void remove(sstable* sst);
     void maybe_done();
+    // Queue an sstable opened with deferred components for the background pass.
+    void queue_deferred_load(sstable& sst);
+    future<> load_deferred_components_in_background();
 private:
     db::large_data_handler& get_large_data_handler() const {
         return _large_data_handler;
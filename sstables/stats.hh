@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cstdint>
+#include <chrono>
 
 namespace sstables {
 
@@ -41,6 +42,13 @@ class sstables_stats {
         uint64_t row_reads = 0;
         uint64_t capped_local_deletion_time = 0;
         uint64_t capped_tombstone_deletion_time = 0;
+        uint64_t deferred_component_loads_on_access = 0;
+        uint64_t deferred_component_loads_in_background = 0;
+        uint64_t deferred_component_load_on_access_us = 0;
+        uint64_t directory_sstables_loaded = 0;
+        uint64_t directory_listing_us = 0;
+        uint64_t directory_loading_us = 0;
+        uint64_t directory_sorting_us = 0;
     } _shard_stats;
 
     stats& _stats = _shard_stats;
@@ -105,6 +113,23 @@ class sstables_stats {
     inline void on_capped_tombstone_deletion_time() {
         ++_stats.capped_tombstone_deletion_time;
     }
+
+    inline void on_deferred_components_load_on_access(std::chrono::steady_clock::duration latency) {
+        ++_stats.deferred_component_loads_on_access;
+        _stats.deferred_component_load_on_access_us += std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    }
+
+    inline void on_deferred_components_load_in_background() {
+        ++_stats.deferred_component_loads_in_background;
+    }
+
+    inline void on_directory_processed(uint64_t sstables, std::chrono::steady_clock::duration listing,
+            std::chrono::steady_clock::duration loading, std::chrono::steady_clock::duration sorting) {
+        _stats.directory_sstables_loaded += sstables;
+        _stats.directory_listing_us += std::chrono::duration_cast<std::chrono::microseconds>(listing).count();
+        _stats.directory_loading_us += std::chrono::duration_cast<std::chrono::microseconds>(loading).count();
+        _stats.directory_sorting_us += std::chrono::duration_cast<std::chrono::microseconds>(sorting).count();
+    }
 };
 
 }
@@ -37,6 +37,7 @@
 #include "version.hh"
 #include "encoding_stats.hh"
 #include "utils/UUID.hh"
+#include <seastar/core/byteorder.hh>
 
 // While the sstable code works with char, bytes_view works with int8_t
 // (signed char). Rather than change all the code, let's do a cast.
@@ -142,6 +143,132 @@ class summary_entry {
     }
 };
 
+// The entries of a Summary, packed for a small memory footprint.
+//
+// The key and the index position of every entry are stored back to back, in
+// their on-disk layout, in a few buffers of up to 128kB, and the only
+// per-entry metadata is its token and the location of its key, 16 bytes in
+// total. Entries are returned by value, viewing the key in place, so that
+// lookups can binary-search the array without materializing it.
+class summary_entries {
+    struct entry_ref {
+        int64_t token;
+        uint32_t buffer;
+        uint32_t offset;
+    };
+    static_assert(sizeof(entry_ref) == 16);
+
+    class buffer {
+        std::unique_ptr<bytes::value_type[]> _data;
+        uint32_t _size;
+        uint32_t _used = 0;
+    public:
+        explicit buffer(uint32_t size) : _data(std::make_unique<bytes::value_type[]>(size)), _size(size) {}
+        const bytes::value_type* data() const { return _data.get(); }
+        uint32_t size() const { return _size; }
+        uint32_t used() const { return _used; }
+        uint32_t free_space() const { return _size - _used; }
+        uint32_t append(bytes_view key, uint64_t position) {
+            auto offset = _used;
+            std::copy_n(key.data(), key.size(), _data.get() + offset);
+            seastar::write_le<uint64_t>(reinterpret_cast<char*>(_data.get() + offset + key.size()), position);
+            _used += key.size() + sizeof(uint64_t);
+            return offset;
+        }
+    };
+
+    static constexpr uint32_t max_buffer_size = 128 * 1024;
+
+    utils::chunked_vector<entry_ref> _refs;
+    std::vector<buffer> _buffers;
+    uint32_t _next_buffer_size = 1 << 10;
+public:
+    class const_iterator {
+        const summary_entries* _entries = nullptr;
+        size_t _idx = 0;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = summary_entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const summary_entry*;
+        using reference = summary_entry;
+
+        const_iterator() = default;
+        const_iterator(const summary_entries& entries, size_t idx) : _entries(&entries), _idx(idx) {}
+
+        summary_entry operator*() const { return (*_entries)[_idx]; }
+        summary_entry operator[](difference_type n) const { return (*_entries)[_idx + n]; }
+
+        const_iterator& operator++() { ++_idx; return *this; }
+        const_iterator operator++(int) { auto it = *this; ++_idx; return it; }
+        const_iterator& operator--() { --_idx; return *this; }
+        const_iterator operator--(int) { auto it = *this; --_idx; return it; }
+        const_iterator& operator+=(difference_type n) { _idx += n; return *this; }
+        const_iterator& operator-=(difference_type n) { _idx -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(*_entries, _idx + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(*_entries, _idx - n); }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+        difference_type operator-(const const_iterator& other) const { return difference_type(_idx) - difference_type(other._idx); }
+
+        bool operator==(const const_iterator& other) const { return _idx == other._idx; }
+        auto operator<=>(const const_iterator& other) const { return _idx <=> other._idx; }
+    };
+    using iterator = const_iterator;
+
+    size_t size() const {
+        return _refs.size();
+    }
+
+    bool empty() const {
+        return _refs.empty();
+    }
+
+    void reserve(size_t n) {
+        _refs.reserve(n);
+    }
+
+    summary_entry operator[](size_t i) const {
+        auto& ref = _refs[i];
+        auto& buf = _buffers[ref.buffer];
+        // The entry extends until the next one, or to the end of the used part of its buffer.
+        uint32_t end = (i + 1 < _refs.size() && _refs[i + 1].buffer == ref.buffer) ? _refs[i + 1].offset : buf.used();
+        auto key_size = end - ref.offset - sizeof(uint64_t);
+        auto position = seastar::read_le<uint64_t>(reinterpret_cast<const char*>(buf.data() + ref.offset + key_size));
+        return summary_entry{dht::token(dht::token::kind::key, ref.token), bytes_view(buf.data() + ref.offset, key_size), position};
+    }
+
+    const_iterator begin() const {
+        return const_iterator(*this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(*this, size());
+    }
+
+    void push_back(const dht::token& token, bytes_view key, uint64_t position) {
+        uint32_t entry_size = key.size() + sizeof(uint64_t);
+        if (_buffers.empty() || _buffers.back().free_space() < entry_size) {
+            _next_buffer_size = std::min(_next_buffer_size << 1, max_buffer_size);
+            // Keys are up to 64kB, so an entry may not fit in a buffer of the usual size.
+            _buffers.emplace_back(std::max(_next_buffer_size, entry_size));
+        }
+        auto offset = _buffers.back().append(key, position);
+        _refs.push_back(entry_ref{token._data, uint32_t(_buffers.size() - 1), offset});
+    }
+
+    uint64_t memory_footprint() const {
+        auto sz = sizeof(entry_ref) * _refs.size();
+        for (auto& buf : _buffers) {
+            sz += buf.size();
+        }
+        return sz;
+    }
+
+    bool operator==(const summary_entries& x) const {
+        return std::equal(begin(), end(), x.begin(), x.end());
+    }
+};
+
 // Note: Sampling level is present in versions ka and higher. We ATM only support ka,
 // so it's always there. But we need to make this conditional if we ever want to support
 // other formats.
@@ -167,7 +294,7 @@ struct summary_ka {
     // not the file. The memory stream effectively begins after the header,
     // so every position here has to be added of sizeof(header).
     utils::chunked_vector<uint32_t> positions;   // can be large, so use a deque instead of a vector
-    utils::chunked_vector<summary_entry> entries;
+    summary_entries entries;
 
     disk_string<uint32_t> first_key;
     disk_string<uint32_t> last_key;
@@ -187,49 +314,14 @@ struct summary_ka {
      * Similar to origin off heap size
      */
     uint64_t memory_footprint() const {
-        auto sz = sizeof(summary_entry) * entries.size() + sizeof(uint32_t) * positions.size() + sizeof(*this);
+        auto sz = entries.memory_footprint() + sizeof(uint32_t) * positions.size() + sizeof(*this);
         sz += first_key.value.size() + last_key.value.size();
-        for (auto& sd : _summary_data) {
-            sz += sd.size();
-        }
         return sz;
     }
 
     explicit operator bool() const {
         return entries.size();
     }
-
-    bytes_view add_summary_data(bytes_view data) {
-        if (_summary_data.empty() || (_summary_index_pos + data.size() > _buffer_size)) {
-            _buffer_size = std::min(_buffer_size << 1, 128u << 10);
-            // Keys are 64kB max, so it might be one key may not fit in a buffer
-            _buffer_size = std::max(_buffer_size, unsigned(data.size()));
-            _summary_data.emplace_back(_buffer_size);
-            _summary_index_pos = 0;
-        }
-
-        auto ret = _summary_data.back().store_at(_summary_index_pos, data);
-        _summary_index_pos += data.size();
-        return ret;
-    }
-private:
-    class summary_data_memory {
-        unsigned _size;
-        std::unique_ptr<bytes::value_type[]> _data;
-    public:
-        summary_data_memory(unsigned size) : _size(size), _data(std::make_unique<bytes::value_type[]>(size)) {}
-        bytes_view store_at(unsigned pos, bytes_view src) {
-            auto addr = _data.get() + pos;
-            std::copy_n(src.data(), src.size(), addr);
-            return bytes_view(addr, src.size());
-        }
-        unsigned size() const {
-            return _size;
-        }
-    };
-    unsigned _buffer_size = 1 << 10;
-    std::vector<summary_data_memory> _summary_data = {};
-    unsigned _summary_index_pos = 0;
 };
 using summary = summary_ka;
 
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unified_compaction_strategy.hh"
+#include "size_tiered_backlog_tracker.hh"
+#include "compaction.hh"
+#include "database.hh"
+#include "service/priority_manager.hh"
+#include "cql3/statements/property_definitions.hh"
+
+#include <boost/range/adaptors.hpp>
+#include <boost/range/algorithm.hpp>
+
+namespace sstables {
+
+extern logging::logger clogger;
+
+unified_compaction_strategy::options::options(const std::map<sstring, sstring>& options) {
+    using namespace cql3::statements;
+    auto base_size_in_mb = property_definitions::to_long("base_sstable_size_in_mb",
+            compaction_strategy_impl::get_value(options, "base_sstable_size_in_mb"), DEFAULT_BASE_SSTABLE_SIZE_IN_MB);
+    if (base_size_in_mb <= 0) {
+        throw exceptions::configuration_exception(format("base_sstable_size_in_mb must be greater than 0, but was {}", base_size_in_mb));
+    }
+    base_sstable_size = uint64_t(base_size_in_mb) * 1024 * 1024;
+
+    max_scaling_parameter = property_definitions::to_int("max_scaling_parameter",
+            compaction_strategy_impl::get_value(options, "max_scaling_parameter"), DEFAULT_MAX_SCALING_PARAMETER);
+    if (max_scaling_parameter < 0) {
+        throw exceptions::configuration_exception(format("max_scaling_parameter must not be negative, but was {}", max_scaling_parameter));
+    }
+
+    if (auto value = compaction_strategy_impl::get_value(options, "scaling_parameter")) {
+        auto w = property_definitions::to_int("scaling_parameter", value, 0);
+        if (std::abs(w) > max_scaling_parameter) {
+            throw exceptions::configuration_exception(format("scaling_parameter must be between -{} and {}, but was {}",
+                    max_scaling_parameter, max_scaling_parameter, w));
+        }
+        fixed_scaling_parameter = w;
+    }
+
+    max_space_amplification = property_definitions::to_double("max_space_amplification",
+            compaction_strategy_impl::get_value(options, "max_space_amplification"), DEFAULT_MAX_SPACE_AMPLIFICATION);
+    if (max_space_amplification <= 1.0) {
+        throw exceptions::configuration_exception(format("max_space_amplification must be greater than 1, but was {}", max_space_amplification));
+    }
+
+    auto interval_in_seconds = property_definitions::to_long("adaptation_interval_in_seconds",
+            compaction_strategy_impl::get_value(options, "adaptation_interval_in_seconds"), DEFAULT_ADAPTATION_INTERVAL.count());
+    if (interval_in_seconds < 0) {
+        throw exceptions::configuration_exception(format("adaptation_interval_in_seconds must not be negative, but was {}", interval_in_seconds));
+    }
+    adaptation_interval = std::chrono::seconds(interval_in_seconds);
+}
+
+unified_compaction_strategy::unified_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+    // Start from the layout of STCS with its default min_threshold, a fan-out of 4.
+    , _scaling_parameter(_options.fixed_scaling_parameter.value_or(std::min(2, _options.max_scaling_parameter)))
+    , _backlog_tracker(std::make_unique<size_tiered_backlog_tracker>())
+{
+}
+
+unsigned unified_compaction_strategy::level_of(uint64_t size, uint64_t base_sstable_size, unsigned fan_out) {
+    unsigned level = 0;
+    while (size >= base_sstable_size) {
+        size /= fan_out;
+        level++;
+    }
+    return level;
+}
+
+double unified_compaction_strategy::space_amplification(const std::vector<shared_sstable>& sstables) {
+    uint64_t total = 0;
+    uint64_t largest = 0;
+    for (auto& sst : sstables) {
+        total += sst->data_size();
+        largest = std::max(largest, sst->data_size());
+    }
+    return largest ? double(total) / largest : 1.0;
+}
+
+int unified_compaction_strategy::next_scaling_parameter(int current, uint64_t reads, uint64_t writes, double space_amplification, const options& opts) {
+    auto target = current;
+    if (reads + writes >= options::MIN_OPERATIONS_FOR_ADAPTATION) {
+        // Each doubling of the write to read ratio is worth one more sstable per compaction.
+        auto ratio = double(writes + 1) / double(reads + 1);
+        target = std::lround(std::log2(ratio));
+    }
+    if (space_amplification > opts.max_space_amplification) {
+        target = std::min(target, current - 1);
+    }
+    target = std::clamp(target, -opts.max_scaling_parameter, opts.max_scaling_parameter);
+    if (target > current) {
+        return current + 1;
+    } else if (target < current) {
+        return current - 1;
+    }
+    return current;
+}
+
+void unified_compaction_strategy::maybe_adapt(column_family& cf, const std::vector<shared_sstable>& candidates) {
+    if (_options.fixed_scaling_parameter) {
+        return;
+    }
+    auto now = db_clock::now();
+    if (_last_adaptation != db_clock::time_point::min() && now - _last_adaptation < _options.adaptation_interval) {
+        return;
+    }
+    uint64_t reads = cf.get_stats().reads.hist.count;
+    uint64_t writes = cf.get_stats().writes.hist.count;
+    if (_last_adaptation != db_clock::time_point::min()) {
+        auto w = next_scaling_parameter(_scaling_parameter, reads - _last_reads, writes - _last_writes, space_amplification(candidates), _options);
+        if (w != _scaling_parameter) {
+            clogger.info("Unified compaction strategy of {}.{} changes its scaling parameter from {} to {} ({} reads, {} writes, space amplification {:.2f})",
+                    cf.schema()->ks_name(), cf.schema()->cf_name(), _scaling_parameter, w,
+                    reads - _last_reads, writes - _last_writes, space_amplification(candidates));
+            _scaling_parameter = w;
+        }
+    }
+    _last_adaptation = now;
+    _last_reads = reads;
+    _last_writes = writes;
+}
+
+std::vector<std::vector<shared_sstable>>
+unified_compaction_strategy::get_levels(const std::vector<shared_sstable>& candidates) const {
+    auto f = fan_out(_scaling_parameter);
+    std::vector<std::vector<shared_sstable>> levels;
+    for (auto& sst : candidates) {
+        auto level = level_of(sst->data_size(), _options.base_sstable_size, f);
+        if (level >= levels.size()) {
+            levels.resize(level + 1);
+        }
+        levels[level].push_back(sst);
+    }
+    for (auto& level : levels) {
+        boost::sort(level, [] (const shared_sstable& a, const shared_sstable& b) {
+            return a->data_size() < b->data_size();
+        });
+    }
+    return levels;
+}
+
+compaction_descriptor
+unified_compaction_strategy::get_sstables_for_compaction(column_family& cf, std::vector<sstables::shared_sstable> candidates) {
+    maybe_adapt(cf, candidates);
+
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    auto gc_before = gc_clock::now() - cf.schema()->gc_grace_seconds();
+    auto t = threshold(_scaling_parameter);
+
+    // The lowest level is compacted first, like the smallest bucket of STCS,
+    // because its compactions are the cheapest and unblock those of the levels above.
+    for (auto& level : get_levels(candidates)) {
+        if (level.size() >= t) {
+            level.resize(std::min(level.size(), std::max(max_threshold, size_t(t))));
+            return compaction_descriptor(std::move(level), cf.get_sstable_set(), service::get_local_compaction_priority());
+        }
+    }
+
+    // Fall back to dropping the tombstones of the oldest sstable which is worth it.
+    auto e = boost::range::remove_if(candidates, [this, &gc_before] (const shared_sstable& sst) {
+        return !worth_dropping_tombstones(sst, gc_before);
+    });
+    if (e != candidates.begin()) {
+        auto it = std::min_element(candidates.begin(), e, [] (const shared_sstable& a, const shared_sstable& b) {
+            return a->get_stats_metadata().min_timestamp < b->get_stats_metadata().min_timestamp;
+        });
+        auto sst = *it;
+        candidates.erase(e, candidates.end());
+        return make_tombstone_compaction_job(cf, sst, candidates);
+    }
+    return compaction_descriptor();
+}
+
+int64_t unified_compaction_strategy::estimated_pending_compactions(column_family& cf) const {
+    size_t max_threshold = cf.schema()->max_compaction_threshold();
+    auto t = threshold(_scaling_parameter);
+    std::vector<shared_sstable> sstables;
+    sstables.reserve(cf.sstables_count());
+    for (auto all_sstables = cf.get_sstables(); auto& entry : *all_sstables) {
+        sstables.push_back(entry);
+    }
+
+    int64_t n = 0;
+    for (auto& level : get_levels(sstables)) {
+        if (level.size() >= t) {
+            n += std::ceil(double(level.size()) / std::max(max_threshold, size_t(t)));
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+unified_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) {
+    // A layout left by another strategy, e.g. the many equally sized sstables of
+    // LCS, or the uncompacted buckets of STCS, shows up as levels holding more
+    // sstables than this strategy would let accumulate. Those are compacted
+    // together, into level 0 in the sense of LCS, so that the leveled metadata
+    // of an LCS layout doesn't survive the migration.
+    size_t max_sstables = std::max(schema->max_compaction_threshold(), int(threshold(_scaling_parameter)));
+    size_t limit = mode == reshape_mode::strict ? threshold(_scaling_parameter) : max_sstables;
+
+    for (auto& level : get_levels(input)) {
+        if (level.size() > limit) {
+            level.resize(std::min(level.size(), max_sstables));
+            clogger.debug("Reshaping {} sstables of {}.{} with unified compaction strategy", level.size(), schema->ks_name(), schema->cf_name());
+            compaction_descriptor desc(std::move(level), std::optional<sstables::sstable_set>(), iop);
+            desc.options = compaction_options::make_reshape();
+            return desc;
+        }
+    }
+    return compaction_descriptor();
+}
+
+}
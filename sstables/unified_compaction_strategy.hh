@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "db_clock.hh"
+
+namespace sstables {
+
+// Unified compaction strategy (UCS) places sstables into levels by size, each
+// level covering sizes fan_out times larger than the level below it, and
+// compacts the sstables of a level together once there are threshold of them.
+//
+// Both the fan-out and the threshold derive from a single scaling parameter W:
+// the fan-out is 2 + |W|; a positive W gives a tiered layout, compacting fan_out
+// sstables at once like STCS does, while a negative W gives a leveled layout,
+// compacting as soon as a level holds two sstables, so that every level holds at
+// most one. Tiered layouts have a low write amplification and a high read and
+// space amplification; leveled ones the opposite.
+//
+// Unless fixed with the scaling_parameter option, W is adapted to the workload of
+// the table: it moves towards the tiered side when the table receives more writes
+// than reads, towards the leveled side when it receives more reads than writes,
+// and towards the leveled side whenever the estimated space amplification exceeds
+// max_space_amplification. W moves by at most one step per adaptation interval, so
+// that a short burst of reads or writes doesn't reshape the whole table.
+class unified_compaction_strategy : public compaction_strategy_impl {
+public:
+    struct options {
+        static constexpr int32_t DEFAULT_BASE_SSTABLE_SIZE_IN_MB = 50;
+        static constexpr int32_t DEFAULT_MAX_SCALING_PARAMETER = 8;
+        static constexpr double DEFAULT_MAX_SPACE_AMPLIFICATION = 4.0;
+        static constexpr std::chrono::seconds DEFAULT_ADAPTATION_INTERVAL = std::chrono::minutes(5);
+        // Minimum number of reads and writes in an interval for their ratio to be considered.
+        static constexpr uint64_t MIN_OPERATIONS_FOR_ADAPTATION = 1000;
+
+        uint64_t base_sstable_size = DEFAULT_BASE_SSTABLE_SIZE_IN_MB * 1024 * 1024;
+        std::optional<int> fixed_scaling_parameter;
+        int max_scaling_parameter = DEFAULT_MAX_SCALING_PARAMETER;
+        double max_space_amplification = DEFAULT_MAX_SPACE_AMPLIFICATION;
+        std::chrono::seconds adaptation_interval = DEFAULT_ADAPTATION_INTERVAL;
+
+        options() = default;
+        explicit options(const std::map<sstring, sstring>& options);
+    };
+private:
+    options _options;
+    int _scaling_parameter;
+    db_clock::time_point _last_adaptation = db_clock::time_point::min();
+    uint64_t _last_reads = 0;
+    uint64_t _last_writes = 0;
+    compaction_backlog_tracker _backlog_tracker;
+
+    std::vector<std::vector<shared_sstable>> get_levels(const std::vector<shared_sstable>& candidates) const;
+
+    void maybe_adapt(column_family& cf, const std::vector<shared_sstable>& candidates);
+public:
+    unified_compaction_strategy(const std::map<sstring, sstring>& options);
+
+    static unsigned fan_out(int scaling_parameter) {
+        return 2 + std::abs(scaling_parameter);
+    }
+
+    static unsigned threshold(int scaling_parameter) {
+        return scaling_parameter < 0 ? 2 : fan_out(scaling_parameter);
+    }
+
+    // Size-level of a sstable of the given size, 0 for sstables smaller than base_sstable_size.
+    static unsigned level_of(uint64_t size, uint64_t base_sstable_size, unsigned fan_out);
+
+    // Estimated space amplification of a set of sstables: their total size over
+    // the size of the largest one, which approximates the size of the data left
+    // after compacting all of them together.
+    static double space_amplification(const std::vector<shared_sstable>& sstables);
+
+    // Returns the scaling parameter to use for the next adaptation interval, given the
+    // current one, the reads and writes in the last interval and the space amplification.
+    static int next_scaling_parameter(int current, uint64_t reads, uint64_t writes, double space_amplification, const options& opts);
+
+    int scaling_parameter() const {
+        return _scaling_parameter;
+    }
+
+    virtual compaction_descriptor get_sstables_for_compaction(column_family& cfs, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual int64_t estimated_pending_compactions(column_family& cf) const override;
+
+    virtual compaction_strategy_type type() const {
+        return compaction_strategy_type::unified;
+    }
+
+    virtual compaction_backlog_tracker& get_backlog_tracker() override {
+        return _backlog_tracker;
+    }
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, const ::io_priority_class& iop, reshape_mode mode) override;
+};
+
+}
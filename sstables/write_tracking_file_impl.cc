@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sstables/write_tracking_file_impl.hh"
+#include <seastar/core/future-util.hh>
+#include "log.hh"
+
+namespace sstables {
+
+extern logging::logger sstlog;
+
+static thread_local data_write_stats data_write_stats_for_shard;
+
+data_write_stats& shard_data_write_stats() noexcept {
+    return data_write_stats_for_shard;
+}
+
+double write_throughput_tracker::throughput() const noexcept {
+    auto seconds = std::chrono::duration<double>(_busy_time).count();
+    return seconds > 0 ? _bytes / seconds : 0;
+}
+
+write_tracking_file_impl::write_tracking_file_impl(file f, lw_shared_ptr<write_throughput_tracker> tracker)
+        : _file(std::move(f)), _tracker(std::move(tracker)) {
+    _memory_dma_alignment = _file.memory_dma_alignment();
+    _disk_read_dma_alignment = _file.disk_read_dma_alignment();
+    _disk_write_dma_alignment = _file.disk_write_dma_alignment();
+}
+
+template <typename Func>
+future<size_t> write_tracking_file_impl::track(Func&& write) {
+    _tracker->on_write_start();
+    shard_data_write_stats().throughput.on_write_start();
+    return futurize_invoke(std::forward<Func>(write)).then_wrapped([tracker = _tracker] (future<size_t> f) {
+        auto on_write_end = [&tracker] (size_t written) {
+            tracker->on_write_end(written);
+            shard_data_write_stats().throughput.on_write_end(written);
+        };
+        if (f.failed()) {
+            on_write_end(0);
+            return f;
+        }
+        auto written = f.get0();
+        on_write_end(written);
+        return make_ready_future<size_t>(written);
+    });
+}
+
+future<size_t>
+write_tracking_file_impl::write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) {
+    return track([this, pos, buffer, len, &pc] {
+        return get_file_impl(_file)->write_dma(pos, buffer, len, pc);
+    });
+}
+
+future<size_t>
+write_tracking_file_impl::write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) {
+    return track([this, pos, iov = std::move(iov), &pc] () mutable {
+        return get_file_impl(_file)->write_dma(pos, std::move(iov), pc);
+    });
+}
+
+file make_write_tracking_file(file f, lw_shared_ptr<write_throughput_tracker> tracker) {
+    return file(::make_shared<write_tracking_file_impl>(std::move(f), std::move(tracker)));
+}
+
+void report_data_write_throughput(const write_throughput_tracker& tracker, const sstring& filename) {
+    shard_data_write_stats().last_writer_throughput = tracker.throughput();
+    sstlog.debug("Wrote {} bytes to {} in {} writes, at most {} in flight, at {:.1f} MB/s",
+            tracker.bytes(), filename, tracker.writes(), tracker.max_in_flight(), tracker.throughput() / (1024 * 1024));
+}
+
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <seastar/core/file.hh>
+#include <seastar/core/shared_ptr.hh>
+#include "seastarx.hh"
+
+namespace sstables {
+
+// Keeps track of the time a file spends with at least one write in flight,
+// and of the bytes written in that time, which together give the throughput
+// its writer achieved, regardless of the time the writer spent producing data.
+class write_throughput_tracker {
+public:
+    using clock = std::chrono::steady_clock;
+private:
+    uint64_t _bytes = 0;
+    uint64_t _writes = 0;
+    unsigned _in_flight = 0;
+    unsigned _max_in_flight = 0;
+    clock::duration _busy_time = clock::duration::zero();
+    clock::time_point _busy_since;
+public:
+    void on_write_start() noexcept {
+        if (!_in_flight++) {
+            _busy_since = clock::now();
+        }
+        _max_in_flight = std::max(_max_in_flight, _in_flight);
+    }
+
+    void on_write_end(size_t bytes) noexcept {
+        _bytes += bytes;
+        ++_writes;
+        if (!--_in_flight) {
+            _busy_time += clock::now() - _busy_since;
+        }
+    }
+
+    uint64_t bytes() const noexcept { return _bytes; }
+    uint64_t writes() const noexcept { return _writes; }
+    unsigned in_flight() const noexcept { return _in_flight; }
+    unsigned max_in_flight() const noexcept { return _max_in_flight; }
+    clock::duration busy_time() const noexcept { return _busy_time; }
+
+    // Bytes written per second while writes were in flight.
+    double throughput() const noexcept;
+};
+
+struct data_write_stats {
+    // Writes of the Data components of all the sstables written by the shard.
+    write_throughput_tracker throughput;
+    // Throughput achieved by the last Data writer closed on the shard.
+    double last_writer_throughput = 0;
+};
+
+data_write_stats& shard_data_write_stats() noexcept;
+
+// Passes writes through to the wrapped file, accounting for them in the given
+// tracker and in shard_data_write_stats().
+class write_tracking_file_impl : public file_impl {
+    file _file;
+    lw_shared_ptr<write_throughput_tracker> _tracker;
+private:
+    template <typename Func>
+    future<size_t> track(Func&& write);
+public:
+    write_tracking_file_impl(file f, lw_shared_ptr<write_throughput_tracker> tracker);
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, const io_priority_class& pc) override;
+
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override;
+
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, const io_priority_class& pc) override {
+        return get_file_impl(_file)->read_dma(pos, buffer, len, pc);
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, const io_priority_class& pc) override {
+        return get_file_impl(_file)->read_dma(pos, iov, pc);
+    }
+
+    virtual future<> flush(void) override {
+        return get_file_impl(_file)->flush();
+    }
+
+    virtual future<struct stat> stat(void) override {
+        return get_file_impl(_file)->stat();
+    }
+
+    virtual future<> truncate(uint64_t length) override {
+        return get_file_impl(_file)->truncate(length);
+    }
+
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return get_file_impl(_file)->discard(offset, length);
+    }
+
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        return get_file_impl(_file)->allocate(position, length);
+    }
+
+    virtual future<uint64_t> size(void) override {
+        return get_file_impl(_file)->size();
+    }
+
+    virtual future<> close() override {
+        return get_file_impl(_file)->close();
+    }
+
+    // Handles of the file don't track their writes.
+    virtual std::unique_ptr<seastar::file_handle_impl> dup() override {
+        return get_file_impl(_file)->dup();
+    }
+
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return get_file_impl(_file)->list_directory(next);
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, const io_priority_class& pc) override {
+        return get_file_impl(_file)->dma_read_bulk(offset, range_size, pc);
+    }
+};
+
+file make_write_tracking_file(file f, lw_shared_ptr<write_throughput_tracker> tracker);
+
+// Accounts for a closed Data writer in shard_data_write_stats() and logs the
+// throughput it achieved.
+void report_data_write_throughput(const write_throughput_tracker& tracker, const sstring& filename);
+
+}
@@ -23,9 +23,19 @@
 #include "writer.hh"
 #include "kl/writer.hh"
 #include "mx/writer.hh"
+#include <seastar/core/align.hh>
 
 namespace sstables {
 
+file_output_stream_options make_data_write_options(const file& f, size_t buffer_size, size_t in_flight_size, const io_priority_class& pc) {
+    auto alignment = std::max(size_t(f.disk_write_dma_alignment()), size_t(DEFAULT_CHUNK_SIZE));
+    file_output_stream_options options;
+    options.io_priority_class = pc;
+    options.buffer_size = align_up(std::max(buffer_size, alignment), alignment);
+    options.write_behind = std::max(in_flight_size / options.buffer_size, size_t(2));
+    return options;
+}
+
 sstable_writer::sstable_writer(sstable& sst, const schema& s, uint64_t estimated_partitions,
         const sstable_writer_config& cfg, encoding_stats enc_stats, const io_priority_class& pc, shard_id shard) {
     if (sst.get_version() >= sstable_version_types::mc) {
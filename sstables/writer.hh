@@ -224,6 +224,14 @@ class checksummed_file_writer : public file_writer {
 using adler32_checksummed_file_writer = checksummed_file_writer<adler32_utils>;
 using crc32_checksummed_file_writer = checksummed_file_writer<crc32_utils>;
 
+// Output stream options for the Data component, which is written sequentially
+// in large chunks: buffers are rounded up to a multiple of the disk write
+// alignment of the file and of the checksum chunk size, so that every write
+// but the last one covers whole aligned blocks, and enough of them are kept in
+// flight to make up in_flight_size, with no fewer than two so that the next
+// buffer fills up while the previous one is being written.
+file_output_stream_options make_data_write_options(const file& f, size_t buffer_size, size_t in_flight_size, const io_priority_class& pc);
+
 template <typename T, typename W>
 requires Writer<W>
 inline void write_vint_impl(W& out, T value) {
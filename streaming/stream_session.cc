@@ -197,8 +197,8 @@ void stream_session::init_messaging_service_handler(netw::messaging_service& ms)
                                                          cf->get_sstables_manager().configure_writer("streaming"),
                                                          encoding_stats{}, pc).then([sst] {
                                 return sst->open_data();
-                            }).then([cf, sst] {
-                                return cf->add_sstable_and_update_cache(sst);
+                            }).then([cf, sst, use_view_update_path] {
+                                return cf->add_sstable_and_update_cache(sst, sstables::offstrategy(!use_view_update_path));
                             }).then([cf, s, sst, use_view_update_path]() mutable -> future<> {
                                 if (!use_view_update_path) {
                                     return make_ready_future<>();
@@ -359,7 +359,7 @@ inline void table::remove_sstable_from_backlog_tracker(compaction_backlog_tracke
     tracker.remove_sstable(std::move(sstable));
 }
 
-void table::add_sstable(sstables::shared_sstable sstable) {
+void table::add_sstable(sstables::shared_sstable sstable, sstables::offstrategy offstrategy) {
     if (belongs_to_other_shard(sstable->get_shards_for_this_sstable())) {
         on_internal_error(tlogger, format("Attempted to load the shared SSTable {} at table", sstable->get_filename()));
     }
@@ -368,6 +368,8 @@ void table::add_sstable(sstables::shared_sstable sstable) {
     new_sstables->insert(sstable);
     if (sstable->requires_view_building()) {
         _sstables_staging.emplace(sstable->generation(), sstable);
+    } else if (offstrategy) {
+        _sstables_maintenance.insert(sstable);
     } else {
         add_sstable_to_backlog_tracker(_compaction_strategy.get_backlog_tracker(), sstable);
     }
@@ -378,12 +380,16 @@ void table::add_sstable(sstables::shared_sstable sstable) {
 }
 
 future<>
-table::add_sstable_and_update_cache(sstables::shared_sstable sst) {
-    return get_row_cache().invalidate(row_cache::external_updater([this, sst] () noexcept {
+table::add_sstable_and_update_cache(sstables::shared_sstable sst, sstables::offstrategy offstrategy) {
+    return get_row_cache().invalidate(row_cache::external_updater([this, sst, offstrategy] () noexcept {
         // FIXME: this is not really noexcept, but we need to provide strong exception guarantees.
         // atomically load all opened sstables into column family.
-        add_sstable(sst);
-        trigger_compaction();
+        add_sstable(sst, offstrategy);
+        if (offstrategy) {
+            _offstrategy_trigger.rearm(lowres_clock::now() + offstrategy_quiet_period);
+        } else {
+            trigger_compaction();
+        }
     }), dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
 }
 
@@ -629,6 +635,7 @@ table::stop() {
     if (_async_gate.is_closed()) {
         return make_ready_future<>();
     }
+    _offstrategy_trigger.cancel();
     return _async_gate.close().then([this] {
         return await_pending_ops().finally([this] {
             return _memtables->request_flush().finally([this] {
@@ -637,6 +644,7 @@ table::stop() {
                         return get_row_cache().invalidate(row_cache::external_updater([this] {
                             _sstables = _compaction_strategy.make_sstable_set(_schema);
                             _sstables_staging.clear();
+                            _sstables_maintenance.clear();
                         })).then([this] {
                             _cache.refresh_snapshot();
                         });
@@ -764,6 +772,9 @@ table::on_compaction_completion(sstables::compaction_completion_desc& desc) {
     // Precompute before so undo_compacted_but_not_deleted can be sure not to throw
     std::unordered_set<sstables::shared_sstable> s(
            desc.old_sstables.begin(), desc.old_sstables.end());
+    for (auto& sst : desc.old_sstables) {
+        _sstables_maintenance.erase(sst);
+    }
     _sstables_compacted_but_not_deleted.insert(_sstables_compacted_but_not_deleted.end(), desc.old_sstables.begin(), desc.old_sstables.end());
     // After we are done, unconditionally remove compacted sstables from _sstables_compacted_but_not_deleted,
     // or they could stay forever in the set, resulting in deleted files remaining
@@ -884,6 +895,51 @@ void table::do_trigger_compaction() {
     }
 }
 
+void table::trigger_offstrategy_compaction() {
+    _offstrategy_trigger.cancel();
+    if (_sstables_maintenance.empty()) {
+        return;
+    }
+    // Run in background, maintenance sstables remain visible to reads meanwhile.
+    (void)_compaction_manager.perform_offstrategy(this);
+}
+
+future<> table::run_offstrategy_compaction() {
+    return seastar::async([this] {
+        tlogger.info("Starting off-strategy compaction for {}.{}, {} candidates were found",
+                _schema->ks_name(), _schema->cf_name(), _sstables_maintenance.size());
+        // Output of reshape stays in the maintenance set until the end, so that
+        // sstables added by repair or streaming meanwhile are reshaped along with it.
+        while (true) {
+            auto input = boost::copy_range<std::vector<sstables::shared_sstable>>(_sstables_maintenance);
+            auto desc = _compaction_strategy.get_reshaping_job(std::move(input), _schema, service::get_local_compaction_priority(),
+                    sstables::reshape_mode::strict);
+            if (desc.sstables.empty()) {
+                break;
+            }
+            desc.creator = [this] (shard_id dummy) {
+                return make_sstable();
+            };
+            auto old_sstables = desc.sstables;
+            auto info = sstables::compact_sstables(std::move(desc), *this).get0();
+            // Reshape doesn't replace its input, do it the way regular compaction would.
+            sstables::compaction_completion_desc completion_desc{std::move(old_sstables), std::move(info.new_sstables)};
+            _sstables_maintenance.insert(completion_desc.new_sstables.begin(), completion_desc.new_sstables.end());
+            _compaction_manager.propagate_replacement(this, completion_desc.old_sstables, completion_desc.new_sstables);
+            on_compaction_completion(completion_desc);
+        }
+
+        for (auto& sst : _sstables_maintenance) {
+            add_sstable_to_backlog_tracker(_compaction_strategy.get_backlog_tracker(), sst);
+        }
+        tlogger.info("Done with off-strategy compaction for {}.{}, {} sstables were integrated into the main set",
+                _schema->ks_name(), _schema->cf_name(), _sstables_maintenance.size());
+        _sstables_maintenance.clear();
+    }).then([this] {
+        trigger_compaction();
+    });
+}
+
 future<> table::run_compaction(sstables::compaction_descriptor descriptor) {
     return compact_sstables(std::move(descriptor));
 }
@@ -898,7 +954,9 @@ void table::set_compaction_strategy(sstables::compaction_strategy_type strategy)
 
     auto new_sstables = new_cs.make_sstable_set(_schema);
     _sstables->for_each_sstable([&] (const sstables::shared_sstable& s) {
-        add_sstable_to_backlog_tracker(new_cs.get_backlog_tracker(), s);
+        if (!_sstables_maintenance.contains(s)) {
+            add_sstable_to_backlog_tracker(new_cs.get_backlog_tracker(), s);
+        }
         new_sstables.insert(s);
     });
 
@@ -978,6 +1036,14 @@ std::vector<sstables::shared_sstable> table::non_staging_sstables() const {
     }));
 }
 
+std::vector<sstables::shared_sstable> table::in_strategy_sstables() const {
+    auto sstables = get_sstables();
+    return boost::copy_range<std::vector<sstables::shared_sstable>>(*sstables
+            | boost::adaptors::filtered([this] (auto& sst) {
+        return !_sstables_staging.contains(sst->generation()) && !_sstables_maintenance.contains(sst);
+    }));
+}
+
 // Gets the list of all sstables in the column family, including ones that are
 // not used for active queries because they have already been compacted, but are
 // waiting for delete_atomically() to return.
@@ -1026,6 +1092,7 @@ table::table(schema_ptr schema, config config, db::commitlog* cl, compaction_man
     , _memtables(_config.enable_disk_writes ? make_memtable_list() : make_memory_only_memtable_list())
     , _compaction_strategy(make_compaction_strategy(_schema->compaction_strategy(), _schema->compaction_strategy_options()))
     , _sstables(make_lw_shared<sstables::sstable_set>(_compaction_strategy.make_sstable_set(_schema)))
+    , _offstrategy_trigger([this] { trigger_offstrategy_compaction(); })
     , _cache(_schema, sstables_as_snapshot_source(), row_cache_tracker, is_continuous::yes)
     , _commitlog(cl)
     , _durable_writes(true)
@@ -1377,7 +1444,9 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
         rebuild_statistics();
 
         return parallel_for_each(p->remove, [this](sstables::shared_sstable s) {
-            remove_sstable_from_backlog_tracker(_compaction_strategy.get_backlog_tracker(), s);
+            if (!_sstables_maintenance.erase(s)) {
+                remove_sstable_from_backlog_tracker(_compaction_strategy.get_backlog_tracker(), s);
+            }
             return sstables::delete_atomically({s});
         }).then([p] {
             return make_ready_future<db::replay_position>(p->rp);
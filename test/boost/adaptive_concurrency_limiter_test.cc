@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include "utils/adaptive_concurrency_limiter.hh"
+
+using namespace std::chrono_literals;
+
+static utils::adaptive_concurrency_limiter::config make_config(uint32_t initial) {
+    utils::adaptive_concurrency_limiter::config cfg;
+    cfg.min_limit = 4;
+    cfg.max_limit = 1000;
+    cfg.initial_limit = initial;
+    return cfg;
+}
+
+// Keeps the limiter saturated, completing each request with the given latency.
+static void run_saturated(utils::adaptive_concurrency_limiter& l, std::chrono::nanoseconds latency, unsigned rounds) {
+    for (unsigned r = 0; r < rounds; ++r) {
+        unsigned admitted = 0;
+        while (l.try_acquire()) {
+            ++admitted;
+        }
+        for (unsigned i = 0; i < admitted; ++i) {
+            l.release(latency);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_rejects_above_limit) {
+    utils::adaptive_concurrency_limiter l(make_config(8));
+    for (unsigned i = 0; i < 8; ++i) {
+        BOOST_REQUIRE(l.try_acquire());
+    }
+    BOOST_REQUIRE(!l.try_acquire());
+    BOOST_REQUIRE_EQUAL(l.rejected(), 1);
+    BOOST_REQUIRE_EQUAL(l.in_flight(), 8);
+    l.release(1ms);
+    BOOST_REQUIRE(l.try_acquire());
+}
+
+BOOST_AUTO_TEST_CASE(test_permit_releases_on_destruction) {
+    utils::adaptive_concurrency_limiter l(make_config(8));
+    {
+        auto p = l.try_get_permit();
+        BOOST_REQUIRE(bool(p));
+        auto p2 = std::move(p);
+        BOOST_REQUIRE(!bool(p));
+        BOOST_REQUIRE_EQUAL(l.in_flight(), 1);
+    }
+    BOOST_REQUIRE_EQUAL(l.in_flight(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_grows_under_stable_latency) {
+    utils::adaptive_concurrency_limiter l(make_config(16));
+    run_saturated(l, 1ms, 100);
+    BOOST_REQUIRE_GT(l.limit(), 16);
+    BOOST_REQUIRE_LE(l.limit(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_does_not_grow_when_underutilized) {
+    utils::adaptive_concurrency_limiter l(make_config(16));
+    for (unsigned i = 0; i < 1000; ++i) {
+        BOOST_REQUIRE(l.try_acquire());
+        l.release(1ms);
+    }
+    BOOST_REQUIRE_EQUAL(l.limit(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(test_shrinks_when_latency_increases) {
+    utils::adaptive_concurrency_limiter l(make_config(200));
+    run_saturated(l, 1ms, 20);
+    auto before = l.limit();
+    run_saturated(l, 50ms, 1);
+    BOOST_REQUIRE_LT(l.limit(), before);
+    BOOST_REQUIRE_GE(l.limit(), 4);
+}
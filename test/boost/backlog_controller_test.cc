@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/util/defer.hh>
+
+#include "backlog_controller.hh"
+
+using namespace std::chrono_literals;
+
+// Adjusts the shares on demand rather than on a timer.
+class test_compaction_controller : public compaction_controller {
+public:
+    test_compaction_controller(seastar::scheduling_group sg, const ::io_priority_class& iop, std::function<float()> current_backlog)
+        : compaction_controller(sg, iop, 1h, std::move(current_backlog))
+    {}
+
+    using backlog_controller::adjust;
+};
+
+SEASTAR_THREAD_TEST_CASE(test_compaction_controller_latency_goals) {
+    auto sg = create_scheduling_group("compaction_controller_test", 100).get0();
+    auto destroy_sg = defer([&] {
+        destroy_scheduling_group(sg).get();
+    });
+    auto iop = engine().register_one_priority_class("compaction_controller_test", 100);
+
+    // At the second control point, which gives 100 shares.
+    float backlog = 1.5;
+    utils::time_estimated_histogram latencies;
+    test_compaction_controller c(sg, iop, [&backlog] { return backlog; });
+    auto stop = defer([&c] {
+        c.shutdown().get();
+    });
+    c.set_latency_goals({{10ms, 0.99, [&latencies] { return latencies; }}});
+
+    auto adjust_with_latency = [&] (std::chrono::microseconds latency) {
+        for (int i = 0; i < 100; ++i) {
+            latencies.add(latency);
+        }
+        c.adjust();
+    };
+
+    adjust_with_latency(1ms);
+    BOOST_REQUIRE_EQUAL(c.latency_factor(), 1.0f);
+    BOOST_REQUIRE_EQUAL(c.shares(), 100.0f);
+    BOOST_REQUIRE_LT(c.latency_pressure(), 1.0f);
+
+    // Above the goal, the shares go down multiplicatively, but not below the first control point.
+    auto previous = c.shares();
+    adjust_with_latency(50ms);
+    BOOST_REQUIRE_GT(c.latency_pressure(), 1.0f);
+    BOOST_REQUIRE_LT(c.latency_factor(), 1.0f);
+    BOOST_REQUIRE_LT(c.shares(), previous);
+    for (int i = 0; i < 20; ++i) {
+        previous = c.shares();
+        adjust_with_latency(50ms);
+        BOOST_REQUIRE_LE(c.shares(), previous);
+    }
+    BOOST_REQUIRE_EQUAL(c.shares(), 50.0f);
+
+    // Only the latency of the last interval counts, so the shares recover once
+    // the latency is back below the goal.
+    previous = c.shares();
+    adjust_with_latency(1ms);
+    BOOST_REQUIRE_LT(c.latency_pressure(), 1.0f);
+    BOOST_REQUIRE_GE(c.shares(), previous);
+    for (int i = 0; i < 30; ++i) {
+        previous = c.shares();
+        adjust_with_latency(1ms);
+        BOOST_REQUIRE_GE(c.shares(), previous);
+    }
+    BOOST_REQUIRE_EQUAL(c.latency_factor(), 1.0f);
+    BOOST_REQUIRE_EQUAL(c.shares(), 100.0f);
+
+    // At the last control point, the backlog takes precedence over the latency goals.
+    backlog = compaction_controller::normalization_factor;
+    for (int i = 0; i < 5; ++i) {
+        adjust_with_latency(50ms);
+    }
+    BOOST_REQUIRE_LT(c.latency_factor(), 1.0f);
+    BOOST_REQUIRE_EQUAL(c.shares(), 1000.0f);
+}
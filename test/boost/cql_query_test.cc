@@ -4881,3 +4881,42 @@ SEASTAR_THREAD_TEST_CASE(test_query_unselected_columns) {
         }
     }, std::move(cfg), thread_attributes{.sched_group = statement_sched_group}).get();
 }
+
+// Statements restricting the whole partition key and a clustering prefix by
+// equalities build their keys from the bound values directly.
+SEASTAR_TEST_CASE(test_prepared_key_equality_restrictions) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p1 int, p2 text, c1 int, c2 int, v int, PRIMARY KEY ((p1, p2), c1, c2))").get();
+        auto I = [] (int32_t x) { return cql3::raw_value::make_value(int32_type->decompose(x)); };
+        auto T = [] (const char* x) { return cql3::raw_value::make_value(utf8_type->decompose(x)); };
+        auto null = cql3::raw_value::make_null();
+
+        auto insert = e.prepare("INSERT INTO t (p1, p2, c1, c2, v) VALUES (?, ?, ?, ?, ?)").get0();
+        for (int p1 : {0, 1}) {
+            for (int c1 : {0, 1}) {
+                for (int c2 : {0, 1}) {
+                    e.execute_prepared(insert, {I(p1), T("a"), I(c1), I(c2), I(100 * p1 + 10 * c1 + c2)}).get();
+                }
+            }
+        }
+
+        auto v = [] (int32_t x) { return int32_type->decompose(x); };
+        auto row = e.prepare("SELECT v FROM t WHERE p1 = ? AND p2 = ? AND c1 = ? AND c2 = ?").get0();
+        assert_that(e.execute_prepared(row, {I(1), T("a"), I(0), I(1)}).get0()).is_rows().with_rows({{v(101)}});
+        assert_that(e.execute_prepared(row, {I(0), T("a"), I(1), I(0)}).get0()).is_rows().with_rows({{v(10)}});
+        assert_that(e.execute_prepared(row, {I(0), T("b"), I(1), I(0)}).get0()).is_rows().is_empty();
+        assert_that(e.execute_prepared(row, {null, T("a"), I(1), I(0)}).get0()).is_rows().is_empty();
+        assert_that(e.execute_prepared(row, {I(0), T("a"), null, I(0)}).get0()).is_rows().is_empty();
+
+        auto prefix = e.prepare("SELECT v FROM t WHERE p1 = ? AND p2 = ? AND c1 = ?").get0();
+        assert_that(e.execute_prepared(prefix, {I(1), T("a"), I(1)}).get0()).is_rows().with_rows({{v(110)}, {v(111)}});
+
+        // Restrictions other than equalities go through the generic path.
+        auto slice = e.prepare("SELECT v FROM t WHERE p1 = ? AND p2 = ? AND c1 = ? AND c2 > ?").get0();
+        assert_that(e.execute_prepared(slice, {I(1), T("a"), I(1), I(0)}).get0()).is_rows().with_rows({{v(111)}});
+
+        auto update = e.prepare("UPDATE t SET v = ? WHERE p1 = ? AND p2 = ? AND c1 = ? AND c2 = ?").get0();
+        e.execute_prepared(update, {I(7), I(1), T("a"), I(0), I(1)}).get();
+        assert_that(e.execute_prepared(row, {I(1), T("a"), I(0), I(1)}).get0()).is_rows().with_rows({{v(7)}});
+    });
+}
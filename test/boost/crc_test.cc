@@ -67,7 +67,8 @@ BOOST_AUTO_TEST_CASE(crc_44_vs_8) {
 BOOST_AUTO_TEST_CASE(crc_process) {
     const size_t max_size = 7 + 4096 + 31;  // cover all code path
     const size_t test_sizes[] = {
-        0, 1, 8, 9, 1023, 1024, 1025, 1032, 1033, 4095, 4096, 4097, max_size
+        0, 1, 8, 9, 255, 256, 257, 264, 265, 512, 1023, 1024, 1025, 1032, 1033, 1279, 1280, 1281,
+        4095, 4096, 4097, max_size
     };
 
     // Create data buffer offset 8 bytes boundary by 1 byte
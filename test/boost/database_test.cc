@@ -40,6 +40,8 @@
 #include "db/config.hh"
 #include "db/commitlog/commitlog_replayer.hh"
 #include "test/lib/tmpdir.hh"
+#include "test/lib/sstable_utils.hh"
+#include "service/storage_service.hh"
 #include "db/data_listeners.hh"
 #include "multishard_mutation_query.hh"
 
@@ -331,6 +333,57 @@ SEASTAR_THREAD_TEST_CASE(test_distributed_loader_with_pending_delete) {
     }, db_cfg_ptr).get();
 }
 
+SEASTAR_THREAD_TEST_CASE(test_distributed_loader_load_and_distribute) {
+    tmpdir data_dir;
+    auto db_cfg_ptr = make_shared<db::config>();
+    db_cfg_ptr->data_file_directories({data_dir.path().string()}, db::config::config_source::CommandLine);
+
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table ks.cf (p int primary key, v int)").get();
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+        auto s = cf.schema();
+        auto upload_dir = (std::filesystem::path(cf.dir()) / "upload").native();
+        recursive_touch_directory(upload_dir).get();
+
+        // A single uploaded sstable holds the partitions of all shards.
+        const size_t partition_count = 100;
+        {
+            std::vector<mutation> muts;
+            for (size_t i = 0; i < partition_count; ++i) {
+                mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(int32_t(i))));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("v"), data_value(int32_t(i)), 1);
+                muts.push_back(std::move(m));
+            }
+            make_sstable_containing([&] {
+                return cf.make_sstable(upload_dir, 1, sstables::sstable::version_types::mc, sstables::sstable::format_types::big);
+            }, std::move(muts));
+        }
+
+        service::get_local_storage_service().load_new_sstables("ks", "cf", false, false, true).get();
+
+        // Every partition ends up on the shard which owns it, and only there.
+        auto loaded = e.db().map_reduce0([] (database& db) {
+            return seastar::async([&db] {
+                auto& cf = db.find_column_family("ks", "cf");
+                auto s = cf.schema();
+                auto rd = cf.make_reader(s, tests::make_permit());
+                size_t partitions = 0;
+                while (auto mo = read_mutation_from_flat_mutation_reader(rd, db::no_timeout).get0()) {
+                    BOOST_REQUIRE_EQUAL(s->get_sharder().shard_of(mo->token()), this_shard_id());
+                    ++partitions;
+                }
+                return partitions;
+            });
+        }, size_t(0), std::plus<size_t>()).get0();
+        BOOST_REQUIRE_EQUAL(loaded, partition_count);
+
+        // The uploaded sstable is removed once its data was written on the owning shards.
+        auto uploaded_toc = sstables::sstable::filename(upload_dir, "ks", "cf", sstables::sstable::version_types::mc, 1,
+                sstables::sstable::format_types::big, component_type::TOC);
+        BOOST_REQUIRE(!file_exists(uploaded_toc).get0());
+    }, db_cfg_ptr).get();
+}
+
 // Snapshot tests and their helpers
 future<> do_with_some_data(std::function<future<> (cql_test_env& env)> func) {
     return seastar::async([func = std::move(func)] () mutable {
@@ -1630,3 +1630,52 @@ SEASTAR_TEST_CASE(indexed_multicolumn_where) {
         eventually_require_rows(e, "select c1 from t where (c1)=(12)", {{I(12)}});
     });
 }
+
+// Queries which don't take the fast path of process_results() have to
+// attach the paging state to their result set themselves.
+SEASTAR_TEST_CASE(test_index_paging_off_the_fast_path) {
+    return do_with_cql_env_thread([] (auto& e) {
+        e.execute_cql("CREATE TABLE tab (p int, c int, v int, PRIMARY KEY (p, c))").get();
+        e.execute_cql("CREATE INDEX ON tab (v)").get();
+
+        const int rows = 5;
+        for (int i = 0; i < rows; ++i) {
+            e.execute_cql(format("INSERT INTO tab (p, c, v) VALUES ({}, {}, 1)", i, i + 1)).get();
+        }
+
+        // Reads all pages of the query, checking that every page which isn't
+        // the last one comes with a paging state, and returns the rows.
+        auto read_all_pages = [&] (sstring query) {
+            std::vector<std::vector<bytes_opt>> all_rows;
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            size_t pages = 0;
+            while (true) {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{1, paging_state, {}, api::new_timestamp()});
+                auto res = e.execute_cql(query, std::move(qo)).get0();
+                auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(res);
+                auto& page = rows->rs().result_set().rows();
+                all_rows.insert(all_rows.end(), page.begin(), page.end());
+                ++pages;
+                if (!rows->rs().get_metadata().flags().contains(cql3::metadata::flag::HAS_MORE_PAGES)) {
+                    break;
+                }
+                auto state = rows->rs().get_metadata().paging_state();
+                BOOST_REQUIRE(state);
+                paging_state = make_lw_shared<service::pager::paging_state>(*state);
+                BOOST_REQUIRE_LE(pages, 2 * rows);
+            }
+            BOOST_REQUIRE_GT(pages, 1);
+            return all_rows;
+        };
+
+        eventually([&] {
+            // Filtering on top of the index.
+            auto filtered = read_all_pages("SELECT p, c, v FROM tab WHERE v = 1 AND c > 1 ALLOW FILTERING");
+            BOOST_REQUIRE_EQUAL(filtered.size(), rows - 1);
+            // A selection which isn't trivial.
+            auto selected = read_all_pages("SELECT p, c, writetime(v) FROM tab WHERE v = 1");
+            BOOST_REQUIRE_EQUAL(selected.size(), rows);
+        });
+    });
+}
@@ -46,6 +46,8 @@
 #include "sstables/compaction_strategy_impl.hh"
 #include "sstables/date_tiered_compaction_strategy.hh"
 #include "sstables/time_window_compaction_strategy.hh"
+#include "sstables/unified_compaction_strategy.hh"
+#include "sstables/write_tracking_file_impl.hh"
 #include "test/lib/mutation_assertions.hh"
 #include "counters.hh"
 #include "cell_locking.hh"
@@ -4521,6 +4523,130 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_tiers_runs_test) {
+  return test_env::do_with([] (test_env& env) {
+    column_family_for_tests cf(env.manager());
+    std::map<sstring, sstring> options{{"sstable_size_in_mb", "1"}};
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+
+    // (max_threshold+1) runs of similar size, made of 2 fragments each.
+    std::vector<sstables::shared_sstable> candidates;
+    int max_threshold = cf->schema()->max_compaction_threshold();
+    int64_t gen = 0;
+    for (auto i = 0; i < (max_threshold+1); i++) {
+        auto run_id = utils::make_random_uuid();
+        for (auto j = 0; j < 2; j++) {
+            auto sst = env.make_sstable(cf.schema(), "", gen++, la, big);
+            sstables::test(sst).set_data_file_size(1);
+            sstables::test(sst).set_run_identifier(run_id);
+            candidates.push_back(std::move(sst));
+        }
+    }
+    auto desc = cs.get_sstables_for_compaction(*cf, std::move(candidates));
+    // Runs are compacted as a whole, and max_threshold caps runs, not fragments.
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), size_t(max_threshold * 2));
+    BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, uint64_t(1) << 20);
+    return make_ready_future<>();
+  });
+}
+
+SEASTAR_TEST_CASE(unified_compaction_strategy_test) {
+  return test_env::do_with([] (test_env& env) {
+    using ucs = sstables::unified_compaction_strategy;
+    column_family_for_tests cf(env.manager());
+
+    // A leveled layout compacts a level as soon as it has two sstables.
+    std::map<sstring, sstring> options{{"base_sstable_size_in_mb", "1"}, {"scaling_parameter", "-2"}};
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::unified, options);
+    std::vector<sstables::shared_sstable> candidates;
+    int64_t gen = 0;
+    for (auto size : {uint64_t(1) << 10, uint64_t(1) << 20, uint64_t(3) << 20}) {
+        auto sst = env.make_sstable(cf.schema(), "", gen++, la, big);
+        sstables::test(sst).set_data_file_size(size);
+        candidates.push_back(std::move(sst));
+    }
+    auto desc = cs.get_sstables_for_compaction(*cf, candidates);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 2);
+    for (auto& sst : desc.sstables) {
+        BOOST_REQUIRE_GE(sst->data_size(), uint64_t(1) << 20);
+    }
+
+    BOOST_REQUIRE_EQUAL(ucs::fan_out(-2), 4);
+    BOOST_REQUIRE_EQUAL(ucs::threshold(-2), 2);
+    BOOST_REQUIRE_EQUAL(ucs::threshold(2), 4);
+    BOOST_REQUIRE_EQUAL(ucs::level_of(1 << 10, 1 << 20, 4), 0);
+    BOOST_REQUIRE_EQUAL(ucs::level_of(3 << 20, 1 << 20, 4), 1);
+    BOOST_REQUIRE_EQUAL(ucs::level_of(4 << 20, 1 << 20, 4), 2);
+
+    // The scaling parameter moves one step at a time, towards tiered for
+    // write-heavy tables and towards leveled for read-heavy ones.
+    ucs::options opts;
+    BOOST_REQUIRE_EQUAL(ucs::next_scaling_parameter(0, 1000, 16000, 1.0, opts), 1);
+    BOOST_REQUIRE_EQUAL(ucs::next_scaling_parameter(4, 1000, 16000, 1.0, opts), 4);
+    BOOST_REQUIRE_EQUAL(ucs::next_scaling_parameter(0, 16000, 1000, 1.0, opts), -1);
+    // Too few operations to tell, so only the space amplification matters.
+    BOOST_REQUIRE_EQUAL(ucs::next_scaling_parameter(2, 1, 10, 1.0, opts), 2);
+    BOOST_REQUIRE_EQUAL(ucs::next_scaling_parameter(2, 1, 10, opts.max_space_amplification + 1, opts), 1);
+    BOOST_REQUIRE_EQUAL(ucs::next_scaling_parameter(-opts.max_scaling_parameter, 1 << 20, 0, 1.0, opts), -opts.max_scaling_parameter);
+    return make_ready_future<>();
+  });
+}
+
+SEASTAR_TEST_CASE(compaction_copies_through_non_overlapping_sstables_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        auto s = schema_builder("tests", "compaction_copy_through")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::mc, big);
+        };
+
+        auto keys = token_generation_for_current_shard(16);
+        auto make_mutations = [&] (unsigned first, unsigned last) {
+            std::vector<mutation> muts;
+            for (unsigned i = first; i < last; i++) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes(keys[i].first)}));
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(i)), api::new_timestamp());
+                muts.push_back(std::move(m));
+            }
+            return muts;
+        };
+        // sst1 doesn't overlap the rest of the input, which has to be merged.
+        auto sst1 = make_sstable_containing(sst_gen, make_mutations(0, 8));
+        auto sst2 = make_sstable_containing(sst_gen, make_mutations(8, 16));
+        auto sst3 = make_sstable_containing(sst_gen, make_mutations(12, 16));
+
+        column_family_for_tests cf(env.manager(), s);
+        auto desc = sstables::compaction_descriptor({sst1, sst2, sst3}, cf->get_sstable_set(), default_priority_class(), 1,
+                std::numeric_limits<uint64_t>::max());
+        auto info = compact_sstables(std::move(desc), *cf, sst_gen).get0();
+
+        // Only the overlapping sstables were merged.
+        BOOST_REQUIRE_EQUAL(info.total_keys_written, 8);
+        BOOST_REQUIRE_EQUAL(info.new_sstables.size(), 2);
+        auto copied = boost::find_if(info.new_sstables, [&] (const shared_sstable& sst) {
+            return sst->get_first_decorated_key().equal(*s, sst1->get_first_decorated_key());
+        });
+        BOOST_REQUIRE(copied != info.new_sstables.end());
+        BOOST_REQUIRE_EQUAL((*copied)->data_size(), sst1->data_size());
+        BOOST_REQUIRE((*copied)->get_last_decorated_key().equal(*s, sst1->get_last_decorated_key()));
+        for (auto& sst : info.new_sstables) {
+            BOOST_REQUIRE_EQUAL(sst->get_sstable_level(), 1);
+        }
+
+        // The level doesn't change, so there's no progress in reusing the input.
+        auto sst4 = make_sstable_containing(sst_gen, make_mutations(0, 8));
+        auto sst5 = make_sstable_containing(sst_gen, make_mutations(8, 16));
+        desc = sstables::compaction_descriptor({sst4, sst5}, cf->get_sstable_set(), default_priority_class());
+        info = compact_sstables(std::move(desc), *cf, sst_gen).get0();
+        BOOST_REQUIRE_EQUAL(info.total_keys_written, 16);
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_set_incremental_selector) {
   return test_env::do_with([] (test_env& env) {
     auto s = make_shared_schema({}, some_keyspace, some_column_family,
@@ -4573,12 +4699,41 @@ SEASTAR_TEST_CASE(sstable_set_incremental_selector) {
         sstable_set::incremental_selector sel = set.make_incremental_selector();
         check(sel, decorated_keys[0], {0, 1, 2});
         check(sel, decorated_keys[1], {0, 1, 2});
-        check(sel, decorated_keys[2], {0});
-        check(sel, decorated_keys[3], {0, 3});
-        check(sel, decorated_keys[4], {0, 3, 4, 5});
-        check(sel, decorated_keys[5], {0, 5});
-        check(sel, decorated_keys[6], {0});
-        check(sel, decorated_keys[7], {0});
+        check(sel, decorated_keys[2], {});
+        check(sel, decorated_keys[3], {3});
+        check(sel, decorated_keys[4], {3, 4, 5});
+        check(sel, decorated_keys[5], {5});
+        check(sel, decorated_keys[6], {});
+        check(sel, decorated_keys[7], {});
+    }
+
+    {
+        // Only unleveled sstables, overlapping each other.
+        auto stcs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, s->compaction_strategy_options());
+        sstable_set set = stcs.make_sstable_set(s);
+        set.insert(sstable_for_overlapping_test(env, s, 0, key_and_token_pair[0].first, key_and_token_pair[1].first, 0));
+        set.insert(sstable_for_overlapping_test(env, s, 1, key_and_token_pair[1].first, key_and_token_pair[3].first, 0));
+        set.insert(sstable_for_overlapping_test(env, s, 2, key_and_token_pair[2].first, key_and_token_pair[2].first, 0));
+        set.insert(sstable_for_overlapping_test(env, s, 3, key_and_token_pair[5].first, key_and_token_pair[7].first, 0));
+
+        sstable_set::incremental_selector sel = set.make_incremental_selector();
+        check(sel, decorated_keys[0], {0});
+        check(sel, decorated_keys[1], {0, 1});
+        check(sel, decorated_keys[2], {1, 2});
+        check(sel, decorated_keys[3], {1});
+        check(sel, decorated_keys[4], {});
+        check(sel, decorated_keys[5], {3});
+        check(sel, decorated_keys[6], {3});
+        check(sel, decorated_keys[7], {3});
+
+        auto gens = [] (const std::vector<shared_sstable>& ssts) {
+            return boost::copy_range<std::unordered_set<int64_t>>(ssts | boost::adaptors::transformed(std::mem_fn(&sstable::generation)));
+        };
+        auto range = dht::partition_range::make({decorated_keys[2], true}, {decorated_keys[5], true});
+        BOOST_REQUIRE(gens(set.select(range)) == std::unordered_set<int64_t>({1, 2, 3}));
+        range = dht::partition_range::make({decorated_keys[4], true}, {decorated_keys[5], false});
+        BOOST_REQUIRE(gens(set.select(range)).empty());
+        BOOST_REQUIRE(gens(set.select(query::full_partition_range)) == std::unordered_set<int64_t>({0, 1, 2, 3}));
     }
 
     return make_ready_future<>();
@@ -4804,6 +4959,110 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     });
 }
 
+SEASTAR_TEST_CASE(tombstone_compaction_includes_shadowed_data_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        auto tmp = tmpdir();
+        auto s = make_shared_schema({}, some_keyspace, some_column_family,
+            {{"p1", utf8_type}}, {{"c1", utf8_type}}, {{"r1", utf8_type}}, {}, utf8_type);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+        };
+
+        auto c_key = clustering_key::from_exploded(*s, {to_bytes("c1")});
+        auto& r1 = *s->get_column_definition("r1");
+        auto deletion_time = gc_clock::now() - gc_clock::duration(DEFAULT_GC_GRACE_SECONDS * 2);
+        auto make_mutations = [&] (api::timestamp_type ts, bool dead) {
+            std::vector<mutation> muts;
+            for (auto i = 0; i < 10; i++) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+                if (dead) {
+                    m.set_clustered_cell(c_key, r1, atomic_cell::make_dead(ts, deletion_time));
+                } else {
+                    m.set_clustered_cell(c_key, r1, atomic_cell::make_live(*utf8_type, ts, utf8_type->decompose("a")));
+                }
+                muts.push_back(std::move(m));
+            }
+            return muts;
+        };
+
+        // Data, tombstones shadowing it, and newer data which they don't shadow.
+        // The oldest data is too large to be compacted along with the tombstones.
+        auto large_data = make_sstable_containing(sst_gen, make_mutations(0, false));
+        auto data = make_sstable_containing(sst_gen, make_mutations(1, false));
+        auto tombstones = make_sstable_containing(sst_gen, make_mutations(2, true));
+        auto newer_data = make_sstable_containing(sst_gen, make_mutations(3, false));
+        // Put the sstables in different size tiers, so only the tombstone compaction applies.
+        sstables::test(data).set_data_file_size(1);
+        sstables::test(tombstones).set_data_file_size(100);
+        sstables::test(newer_data).set_data_file_size(10000);
+        sstables::test(large_data).set_data_file_size(1000000);
+        sstables::test(tombstones).set_data_file_write_time(db_clock::time_point::min());
+
+        column_family_for_tests cf(env.manager(), s);
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, s->compaction_strategy_options());
+        auto descriptor = cs.get_sstables_for_compaction(*cf, { large_data, data, tombstones, newer_data });
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), 2);
+        BOOST_REQUIRE(descriptor.sstables[0] == tombstones);
+        BOOST_REQUIRE(descriptor.sstables[1] == data);
+
+        // The job grows by at most tombstone_compaction_max_expansion times the tombstone sstable.
+        uint64_t added_size = 0;
+        for (auto& sst : boost::make_iterator_range(descriptor.sstables.begin() + 1, descriptor.sstables.end())) {
+            added_size += sst->data_size();
+        }
+        BOOST_REQUIRE_LE(added_size, tombstones->data_size() * compaction_strategy_impl::tombstone_compaction_max_expansion);
+    });
+}
+
+// The tombstone compaction which the unified strategy falls back to is bounded
+// in size like the one of STCS.
+SEASTAR_TEST_CASE(unified_compaction_strategy_tombstone_compaction_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        auto tmp = tmpdir();
+        auto s = make_shared_schema({}, some_keyspace, some_column_family,
+            {{"p1", utf8_type}}, {{"c1", utf8_type}}, {{"r1", utf8_type}}, {}, utf8_type);
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, la, big);
+        };
+
+        auto c_key = clustering_key::from_exploded(*s, {to_bytes("c1")});
+        auto& r1 = *s->get_column_definition("r1");
+        auto deletion_time = gc_clock::now() - gc_clock::duration(DEFAULT_GC_GRACE_SECONDS * 2);
+        auto make_mutations = [&] (api::timestamp_type ts, bool dead) {
+            std::vector<mutation> muts;
+            for (auto i = 0; i < 10; i++) {
+                mutation m(s, partition_key::from_exploded(*s, {to_bytes("key" + to_sstring(i))}));
+                if (dead) {
+                    m.set_clustered_cell(c_key, r1, atomic_cell::make_dead(ts, deletion_time));
+                } else {
+                    m.set_clustered_cell(c_key, r1, atomic_cell::make_live(*utf8_type, ts, utf8_type->decompose("a")));
+                }
+                muts.push_back(std::move(m));
+            }
+            return muts;
+        };
+
+        auto large_data = make_sstable_containing(sst_gen, make_mutations(0, false));
+        auto data = make_sstable_containing(sst_gen, make_mutations(1, false));
+        auto tombstones = make_sstable_containing(sst_gen, make_mutations(2, true));
+        // Levels hold too few sstables to be compacted.
+        sstables::test(data).set_data_file_size(1000);
+        sstables::test(tombstones).set_data_file_size(1000);
+        sstables::test(large_data).set_data_file_size(uint64_t(1) << 30);
+        sstables::test(tombstones).set_data_file_write_time(db_clock::time_point::min());
+
+        column_family_for_tests cf(env.manager(), s);
+        std::map<sstring, sstring> options{{"base_sstable_size_in_mb", "1"}, {"scaling_parameter", "2"}};
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::unified, options);
+        auto descriptor = cs.get_sstables_for_compaction(*cf, { large_data, data, tombstones });
+        BOOST_REQUIRE_EQUAL(descriptor.sstables.size(), 2);
+        BOOST_REQUIRE(descriptor.sstables[0] == tombstones);
+        BOOST_REQUIRE(descriptor.sstables[1] == data);
+    });
+}
+
 SEASTAR_TEST_CASE(sstable_owner_shards) {
     return test_env::do_with_async([] (test_env& env) {
         storage_service_for_tests ssft;
@@ -6021,6 +6280,353 @@ SEASTAR_TEST_CASE(partial_sstable_run_filtered_out_test) {
     });
 }
 
+SEASTAR_TEST_CASE(offstrategy_sstables_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+
+        auto s = schema_builder("tests", "offstrategy_sstables_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+
+        auto tmp = tmpdir();
+
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->enable();
+
+        column_family::config cfg = column_family_test_config(env.manager());
+        cfg.datadir = tmp.path().string();
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        auto cl_stats = make_lw_shared<cell_locker_stats>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, *cl_stats, *tracker);
+        cf->start();
+        cf->mark_ready_for_writes();
+
+        auto sst_gen = [&cf] () mutable {
+            return cf->make_sstable();
+        };
+
+        auto tokens = token_generation_for_current_shard(5);
+        std::vector<mutation> muts;
+        for (auto& [key, token] : tokens) {
+            mutation mut(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            mut.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 0);
+            muts.push_back(mut);
+            cf->add_sstable_and_update_cache(make_sstable_containing(sst_gen, {std::move(mut)}), sstables::offstrategy::yes).get();
+        }
+
+        // Off-strategy sstables are readable, but not compacted by the strategy.
+        BOOST_REQUIRE_EQUAL(cf->get_sstables()->size(), 5);
+        BOOST_REQUIRE_EQUAL(cf->maintenance_sstables_count(), 5);
+        BOOST_REQUIRE(cf->in_strategy_sstables().empty());
+        for (auto& mut : muts) {
+            auto mp = cf->find_partition_slow(s, tests::make_permit(), mut.key()).get0();
+            BOOST_REQUIRE(mp);
+        }
+
+        cm->perform_offstrategy(cf.get()).get();
+
+        // They are reshaped into a single sstable and handed over to the strategy.
+        BOOST_REQUIRE_EQUAL(cf->maintenance_sstables_count(), 0);
+        BOOST_REQUIRE_EQUAL(cf->get_sstables()->size(), 1);
+        BOOST_REQUIRE_EQUAL(cf->in_strategy_sstables().size(), 1);
+        auto reader = sstable_reader(cf->in_strategy_sstables().front(), s);
+        auto assertions = assert_that(std::move(reader));
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+        for (auto& mut : muts) {
+            assertions.produces(mut);
+        }
+        assertions.produces_end_of_stream();
+
+        cf->stop().get();
+        cm->stop().get();
+    });
+}
+
+SEASTAR_TEST_CASE(garbage_collection_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+
+        auto builder = schema_builder("tests", "garbage_collection_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        builder.set_gc_grace_seconds(0);
+        auto s = builder.build();
+
+        auto tmp = tmpdir();
+
+        auto cm = make_lw_shared<compaction_manager>();
+        cm->enable();
+
+        column_family::config cfg = column_family_test_config(env.manager());
+        cfg.datadir = tmp.path().string();
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        auto cl_stats = make_lw_shared<cell_locker_stats>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, *cl_stats, *tracker);
+        cf->start();
+        cf->mark_ready_for_writes();
+
+        auto sst_gen = [&cf] () mutable {
+            return cf->make_sstable();
+        };
+
+        auto tokens = token_generation_for_current_shard(2);
+        auto alpha = partition_key::from_exploded(*s, {to_bytes(tokens[0].first)});
+        auto beta = partition_key::from_exploded(*s, {to_bytes(tokens[1].first)});
+
+        mutation deleted(s, alpha);
+        deleted.partition().apply(tombstone(1, gc_clock::now() - std::chrono::hours(1)));
+        auto expired = make_sstable_containing(sst_gen, {std::move(deleted)});
+
+        mutation live(s, beta);
+        live.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), 2);
+        auto untouched = make_sstable_containing(sst_gen, {live});
+
+        cf->add_sstable_and_update_cache(expired).get();
+        cf->add_sstable_and_update_cache(untouched).get();
+        BOOST_REQUIRE_EQUAL(cf->get_sstables()->size(), 2);
+
+        cm->perform_garbage_collection(cf.get()).get();
+
+        // The fully expired sstable is dropped, while the one without anything
+        // to purge isn't rewritten.
+        BOOST_REQUIRE_EQUAL(cf->get_sstables()->size(), 1);
+        BOOST_REQUIRE(*cf->get_sstables()->begin() == untouched);
+        assert_that(sstable_reader(untouched, s))
+            .produces(live)
+            .produces_end_of_stream();
+
+        cf->stop().get();
+        cm->stop().get();
+    });
+}
+
+// Check that compaction yields the same result when partitions of an input are
+// skipped because they are wholly shadowed by a partition tombstone of another.
+SEASTAR_TEST_CASE(shadowed_partition_skipping_test) {
+    BOOST_REQUIRE(smp::count == 1);
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+
+        auto s = schema_builder("tests", "shadowed_partition_skipping_test")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp, gen = make_lw_shared<unsigned>(1)] () mutable {
+            return env.make_sstable(s, tmp.path().string(), (*gen)++, sstables::sstable::version_types::mc, big);
+        };
+
+        auto keys = token_generation_for_current_shard(2);
+        auto alpha = partition_key::from_exploded(*s, {to_bytes(keys[0].first)});
+        auto beta = partition_key::from_exploded(*s, {to_bytes(keys[1].first)});
+
+        auto make_rows = [&] (const partition_key& pk, int rows, api::timestamp_type ts) {
+            mutation m(s, pk);
+            for (int i = 0; i < rows; i++) {
+                auto ck = clustering_key::from_exploded(*s, {int32_type->decompose(i)});
+                m.set_clustered_cell(ck, bytes("v"), data_value(i), ts);
+            }
+            return m;
+        };
+        auto make_delete = [&] (const partition_key& pk, api::timestamp_type ts) {
+            mutation m(s, pk);
+            m.partition().apply(tombstone(ts, gc_clock::now()));
+            return m;
+        };
+
+        // All data of the oldest sstable is shadowed by the partition tombstones of the
+        // second one, while the row of the newest one survives the tombstone of beta.
+        auto oldest = make_sstable_containing(sst_gen, {make_rows(alpha, 1000, 1), make_rows(beta, 1000, 1)});
+        auto deletions = make_sstable_containing(sst_gen, {make_delete(alpha, 10), make_delete(beta, 10)});
+        auto newest_beta = make_rows(beta, 1, 20);
+        auto newest = make_sstable_containing(sst_gen, {newest_beta});
+
+        column_family_for_tests cf(env.manager(), s);
+        auto& cm = cf->get_compaction_manager();
+        auto skipped_before = cm.get_stats().shadowed_partitions_skipped;
+        auto info = compact_sstables(sstables::compaction_descriptor({oldest, deletions, newest}, cf->get_sstable_set(), default_priority_class()),
+                *cf, sst_gen).get0();
+        // Both partitions of the oldest sstable are skipped, and nothing else.
+        BOOST_REQUIRE_EQUAL(info.shadowed_partitions_skipped, 2);
+        BOOST_REQUIRE_EQUAL(cm.get_stats().shadowed_partitions_skipped - skipped_before, 2);
+        auto& compacted = info.new_sstables;
+        BOOST_REQUIRE_EQUAL(compacted.size(), 1);
+
+        auto expected_beta = make_delete(beta, 10);
+        expected_beta.apply(newest_beta);
+        auto expected = std::vector<mutation>{make_delete(alpha, 10), expected_beta};
+        boost::sort(expected, mutation_decorated_key_less_comparator());
+        assert_that(sstable_reader(compacted.front(), s))
+            .produces(expected[0])
+            .produces(expected[1])
+            .produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(deferred_components_load_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+
+        auto s = schema_builder("tests", "deferred_components_load_test")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("v", int32_type)
+                .build();
+
+        auto tmp = tmpdir();
+        auto sst_gen = [&env, s, &tmp] () {
+            return env.make_sstable(s, tmp.path().string(), 1, sstables::sstable::version_types::mc, big);
+        };
+
+        std::vector<mutation> muts;
+        for (auto& [key, token] : token_generation_for_current_shard(100)) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("v"), data_value(int32_t(muts.size())), 1);
+            muts.push_back(std::move(m));
+        }
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+        auto written = make_sstable_containing(sst_gen, muts);
+
+        auto sst = env.make_sstable(s, tmp.path().string(), 1, sstables::sstable::version_types::mc, big);
+        sst->load(default_priority_class(), sstables::defer_components::yes).get();
+        BOOST_REQUIRE(sst->has_deferred_components());
+        BOOST_REQUIRE(sst->get_first_decorated_key().equal(*s, muts.front().decorated_key()));
+        BOOST_REQUIRE(sst->get_last_decorated_key().equal(*s, muts.back().decorated_key()));
+        BOOST_REQUIRE(sst->get_key_samples(*s, dht::token_range::make_open_ended_both_sides()).empty());
+        BOOST_REQUIRE_EQUAL(sst->estimated_keys_for_range(dht::token_range::make_open_ended_both_sides()), sst->get_estimated_key_count());
+
+        // A single partition read loads the deferred components before looking up the index.
+        auto& mut = muts[muts.size() / 2];
+        auto pr = dht::partition_range::make_singular(mut.decorated_key());
+        assert_that(sstable_reader(sst, s, pr))
+            .produces(mut)
+            .produces_end_of_stream();
+        BOOST_REQUIRE(!sst->has_deferred_components());
+        BOOST_REQUIRE_EQUAL(sst->get_summary().entries.size(), written->get_summary().entries.size());
+        BOOST_REQUIRE(sst->filter_has_key(*s, mut.key()));
+
+        auto rd = assert_that(sstable_reader(sst, s));
+        for (auto& m : muts) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+    });
+}
+
+SEASTAR_TEST_CASE(partition_trie_lookup_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+
+        auto s = schema_builder("tests", "partition_trie_lookup_test")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("v", int32_type)
+                .build();
+
+        // Every other key goes to the sstable, the others are looked up as absent ones.
+        std::vector<mutation> muts;
+        std::vector<dht::decorated_key> absent;
+        for (auto& [key, token] : token_generation_for_current_shard(200)) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("v"), data_value(int32_t(muts.size())), 1);
+            if (muts.size() > absent.size()) {
+                absent.push_back(m.decorated_key());
+            } else {
+                muts.push_back(std::move(m));
+            }
+        }
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+
+        auto tmp = tmpdir();
+        auto cfg = env.manager().configure_writer();
+        cfg.write_partition_trie = true;
+        auto sst = make_sstable(env, s, tmp.path().string(), muts, cfg, sstables::sstable::version_types::mc);
+        BOOST_REQUIRE(sst->has_partition_trie());
+        BOOST_REQUIRE(sst->partitions_size() > 0);
+
+        auto present = [&] (const dht::decorated_key& dk) {
+            sstables::index_reader idx(sst, tests::make_permit(), default_priority_class(), {});
+            auto found = idx.advance_lower_and_check_if_present(dk).get0();
+            idx.close().get();
+            return found;
+        };
+        for (auto& m : muts) {
+            BOOST_REQUIRE(present(m.decorated_key()));
+        }
+        for (auto& dk : absent) {
+            BOOST_REQUIRE(!present(dk));
+        }
+        // The pages of the trie are kept by the sstable, past the readers which read them.
+        BOOST_REQUIRE(sst->get_partition_trie().cached_bytes() > 0);
+
+        for (auto& m : muts) {
+            auto pr = dht::partition_range::make_singular(m.decorated_key());
+            assert_that(sstable_reader(sst, s, pr))
+                .produces(m)
+                .produces_end_of_stream();
+        }
+
+        // Moving past the partitions read through the trie continues through the summary.
+        for (size_t i = 0; i < muts.size(); i += 7) {
+            sstables::index_reader idx(sst, tests::make_permit(), default_priority_class(), {});
+            BOOST_REQUIRE(idx.advance_lower_and_check_if_present(muts[i].decorated_key()).get0());
+            for (size_t j = i + 1; j < muts.size() && j < i + 4; ++j) {
+                idx.advance_to_next_partition().get();
+                BOOST_REQUIRE(!idx.eof());
+                idx.read_partition_data().get();
+                auto pk = idx.partition_key().to_partition_key(*s);
+                BOOST_REQUIRE(pk.equal(*s, muts[j].key()));
+            }
+            idx.close().get();
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(data_write_throughput_test) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+
+        auto builder = schema_builder("tests", "data_write_throughput_test")
+                .with_column("pk", int32_type, column_kind::partition_key)
+                .with_column("ck", int32_type, column_kind::clustering_key)
+                .with_column("v", bytes_type);
+        builder.set_compressor_params(compression_parameters::no_compression());
+        auto s = builder.build();
+
+        mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(0)));
+        for (int ck = 0; ck < 100; ++ck) {
+            m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), *s->get_column_definition("v"),
+                    atomic_cell::make_live(*bytes_type, 1, bytes(5000, int8_t(ck))));
+        }
+
+        // The smallest buffers, which are rounded up to the checksum chunk size.
+        auto cfg = env.manager().configure_writer();
+        cfg.data_write_buffer_size = 1;
+        cfg.data_write_in_flight_size = 0;
+
+        auto& stats = shard_data_write_stats().throughput;
+        auto bytes_before = stats.bytes();
+        auto writes_before = stats.writes();
+        auto tmp = tmpdir();
+        auto sst = make_sstable(env, s, tmp.path().string(), {m}, cfg, sstables::sstable::version_types::md);
+
+        BOOST_REQUIRE_GE(stats.bytes() - bytes_before, sst->data_size());
+        BOOST_REQUIRE_GE(stats.writes() - writes_before, sst->data_size() / DEFAULT_CHUNK_SIZE);
+        BOOST_REQUIRE_EQUAL(stats.in_flight(), 0);
+        BOOST_REQUIRE_GT(shard_data_write_stats().last_writer_throughput, 0);
+
+        assert_that(sst->as_mutation_source().make_reader(s, tests::make_permit()))
+            .produces(m)
+            .produces_end_of_stream();
+    });
+}
+
 // Make sure that a custom tombstone-gced-only writer will be feeded with gc'able tombstone
 // from the regular compaction's input sstable.
 SEASTAR_TEST_CASE(purged_tombstone_consumer_sstable_test) {
@@ -339,6 +339,36 @@ SEASTAR_THREAD_TEST_CASE(sstable_directory_test_generation_sanity) {
   }).get();
 }
 
+// Test that sstables loaded while the directory is still being listed are all accounted for,
+// and that those of a temporary TOC are dropped even when their TOC was listed first.
+SEASTAR_THREAD_TEST_CASE(sstable_directory_test_pipelined_loading) {
+  sstables::test_env::do_with_sharded_async([] (sharded<test_env>& env) {
+    auto dir = tmpdir();
+    constexpr int64_t nr_sstables = 16;
+    for (int64_t generation = 1; generation <= nr_sstables; ++generation) {
+        make_sstable_for_this_shard(std::bind(new_sstable, std::ref(env.local()), dir.path(), generation * smp::count));
+    }
+    auto sst = make_sstable_for_this_shard(std::bind(new_sstable, std::ref(env.local()), dir.path(), (nr_sstables + 1) * smp::count));
+    auto f = open_file_dma(sst->filename(sstables::component_type::TemporaryTOC), open_flags::rw | open_flags::create | open_flags::truncate).get0();
+    f.close().get();
+
+   with_sstable_directory(dir.path(), 2,
+            sstable_directory::need_mutate_level::no,
+            sstable_directory::lack_of_toc_fatal::yes,
+            sstable_directory::enable_dangerous_direct_import_of_cassandra_counters::no,
+            sstable_directory::allow_loading_materialized_view::no,
+            sstable_from_existing_file(env),
+            [&] (sharded<sstables::sstable_directory>& sstdir) {
+    distributed_loader::process_sstable_dir(sstdir).get();
+    auto& stats = sstdir.local().get_process_stats();
+    BOOST_REQUIRE_EQUAL(stats.sstables, size_t(nr_sstables));
+    BOOST_REQUIRE(stats.listing <= stats.loading);
+    int64_t max_generation_seen = highest_generation_seen(sstdir).get0();
+    BOOST_REQUIRE_EQUAL(max_generation_seen, nr_sstables * smp::count);
+   });
+  }).get();
+}
+
 future<> verify_that_all_sstables_are_local(sharded<sstable_directory>& sstdir, unsigned expected_sstables) {
     return do_with(std::make_unique<std::atomic<unsigned>>(0), [&sstdir, expected_sstables] (std::unique_ptr<std::atomic<unsigned>>& count) {
         return sstdir.invoke_on_all([count = count.get()] (sstable_directory& d) {
@@ -29,6 +29,7 @@
 #include <seastar/core/do_with.hh>
 #include <seastar/core/thread.hh>
 #include "sstables/sstables.hh"
+#include "sstables/promoted_index_cache.hh"
 #include "database.hh"
 #include "timestamp.hh"
 #include "schema_builder.hh"
@@ -1716,3 +1717,102 @@ SEASTAR_TEST_CASE(test_static_compact_tables_are_read) {
         }
     });
 }
+
+SEASTAR_TEST_CASE(test_promoted_index_blocks_are_shared_across_reads) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        simple_schema ss;
+        auto s = ss.schema();
+        auto pk = ss.make_pkey(make_local_key(s));
+
+        mutation m(s, pk);
+        for (int i = 0; i < 64; ++i) {
+            ss.add_row(m, ss.make_ckey(i), "v");
+        }
+
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(m);
+
+        tmpdir dir;
+        auto sst = env.make_sstable(s, dir.path().string(), 1, sstables::sstable::version_types::md, sstables::sstable::format_types::big);
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.promoted_index_block_size = 1;
+        sst->write_components(mt->make_flat_reader(s, tests::make_permit()), 1, s, cfg, mt->get_encoding_stats()).get();
+        sst->load().get();
+
+        auto& stats = env.manager().get_promoted_index_cache().get_stats();
+        auto read_slice = [&] (int ck) {
+            auto slice = partition_slice_builder(*s)
+                .with_range(query::clustering_range::make_singular(ss.make_ckey(ck)))
+                .build();
+            assert_that(sst->as_mutation_source().make_reader(s, tests::make_permit(), dht::partition_range::make_singular(pk), slice))
+                .produces(m, slice.row_ranges(*s, pk.key()))
+                .produces_end_of_stream();
+        };
+
+        auto hits = stats.hits;
+        auto misses = stats.misses;
+        read_slice(17);
+        BOOST_REQUIRE_EQUAL(stats.misses, misses + 1);
+        BOOST_REQUIRE_GT(stats.used_bytes, 0);
+
+        // The second read finds the blocks parsed by the first one.
+        auto populations = promoted_index_cache_metrics.populations;
+        read_slice(17);
+        BOOST_REQUIRE_EQUAL(stats.hits, hits + 1);
+        BOOST_REQUIRE_EQUAL(promoted_index_cache_metrics.populations, populations);
+
+        read_slice(42);
+        BOOST_REQUIRE_EQUAL(stats.hits, hits + 2);
+
+        auto entries = stats.entries;
+        sst = {};
+        BOOST_REQUIRE_EQUAL(stats.entries, entries - 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_shared_promoted_index_blocks_are_bounded) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        simple_schema ss;
+        auto s = ss.schema();
+        auto pk = ss.make_pkey(make_local_key(s));
+
+        const int rows = 50000;
+        mutation m(s, pk);
+        for (int i = 0; i < rows; ++i) {
+            ss.add_row(m, ss.make_ckey(i), "v");
+        }
+
+        auto mt = make_lw_shared<memtable>(s);
+        mt->apply(m);
+
+        tmpdir dir;
+        auto sst = env.make_sstable(s, dir.path().string(), 1, sstables::sstable::version_types::md, sstables::sstable::format_types::big);
+        sstable_writer_config cfg = env.manager().configure_writer();
+        cfg.promoted_index_block_size = 1;
+        sst->write_components(mt->make_flat_reader(s, tests::make_permit()), 1, s, cfg, mt->get_encoding_stats()).get();
+        sst->load().get();
+
+        // Walk the whole partition, visiting most of its blocks.
+        auto slice_builder = partition_slice_builder(*s);
+        for (int i = 0; i < rows; i += 10) {
+            slice_builder.with_range(query::clustering_range::make_singular(ss.make_ckey(i)));
+        }
+        auto slice = slice_builder.build();
+
+        auto& pi_cache = env.manager().get_promoted_index_cache();
+        auto& stats = pi_cache.get_stats();
+        auto max_entry_bytes = env.manager().config().promoted_index_cache_size_in_mb() * 1024 * 1024 / promoted_index_cache::max_entry_fraction;
+        auto evictions = promoted_index_cache_metrics.evictions;
+        for (int i = 0; i < 2; ++i) {
+            assert_that(sst->as_mutation_source().make_reader(s, tests::make_permit(), dht::partition_range::make_singular(pk), slice))
+                .produces(m, slice.row_ranges(*s, pk.key()))
+                .produces_end_of_stream();
+            // At most one block goes in past the limit of the entry.
+            BOOST_REQUIRE_LE(stats.used_bytes, max_entry_bytes + 1024);
+        }
+        // The reads went on with private blocks, dropping the ones behind them.
+        BOOST_REQUIRE_GT(promoted_index_cache_metrics.evictions, evictions);
+    });
+}
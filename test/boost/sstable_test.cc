@@ -25,11 +25,13 @@
 #include <seastar/core/aligned_buffer.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/byteorder.hh>
 #include "sstables/sstables.hh"
 #include "sstables/compaction_manager.hh"
 #include "sstables/key.hh"
 #include "test/lib/sstable_utils.hh"
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
 #include "schema.hh"
 #include "compress.hh"
 #include "database.hh"
@@ -800,7 +802,7 @@ SEASTAR_TEST_CASE(all_in_place) {
         auto& summary = sstables::test(sstp)._summary();
 
         int idx = 0;
-        for (auto& e: summary.entries) {
+        for (auto&& e: summary.entries) {
             auto key = sstables::key::from_bytes(bytes(e.key));
             BOOST_REQUIRE(sstables::test(sstp).binary_search(sstp->get_schema()->get_partitioner(), summary.entries, key) == idx++);
         }
@@ -808,6 +810,86 @@ SEASTAR_TEST_CASE(all_in_place) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(summary_entries_packing) {
+    // Enough entries, some with large keys, to span buffers of all sizes.
+    sstables::summary_entries entries;
+    std::vector<std::tuple<dht::token, bytes, uint64_t>> expected;
+    for (int64_t i = 0; i < 5000; i++) {
+        auto key = bytes(i % 97 == 0 ? 40000 : size_t(i % 13), int8_t(i));
+        expected.emplace_back(dht::token(dht::token::kind::key, i * 7919), key, uint64_t(i) << 20);
+        entries.push_back(std::get<0>(expected.back()), key, std::get<2>(expected.back()));
+    }
+
+    BOOST_REQUIRE_EQUAL(entries.size(), expected.size());
+    size_t idx = 0;
+    for (auto&& e : entries) {
+        auto& [token, key, position] = expected[idx++];
+        BOOST_REQUIRE(e.token == token);
+        BOOST_REQUIRE(e.key == bytes_view(key));
+        BOOST_REQUIRE_EQUAL(e.position, position);
+    }
+    BOOST_REQUIRE_EQUAL(idx, expected.size());
+    BOOST_REQUIRE(entries[expected.size() - 1] == *(entries.end() - 1));
+}
+
+// A Summary whose positions don't describe its entries, or whose entries are
+// cut short, is rejected as malformed and regenerated from the Index.
+SEASTAR_TEST_CASE(corrupt_summary_is_regenerated) {
+    return test_env::do_with_async([] (test_env& env) {
+        const sstring dir = "test/resource/sstables/bigsummary";
+        const unsigned long generation = 76;
+        auto original = env.reusable_sst(uncompressed_schema(), dir, generation).get0();
+        auto& expected = sstables::test(original).get_summary();
+        BOOST_REQUIRE_GT(expected.header.size, 2);
+
+        auto position_offset = [] (size_t idx) {
+            return sizeof(summary::header) + idx * sizeof(uint32_t);
+        };
+        using corruption = std::function<void (char* buf, size_t& size)>;
+        std::vector<corruption> corruptions = {
+            // A position past the end of the entries.
+            [&] (char* buf, size_t& size) {
+                seastar::write_le<uint32_t>(buf + position_offset(1), std::numeric_limits<uint32_t>::max());
+            },
+            // Positions out of order.
+            [&] (char* buf, size_t& size) {
+                seastar::write_le<uint32_t>(buf + position_offset(1), expected.positions[2]);
+                seastar::write_le<uint32_t>(buf + position_offset(2), expected.positions[1]);
+            },
+            // Entries cut short.
+            [&] (char* buf, size_t& size) {
+                size = sizeof(summary::header) + expected.positions[1] + 1;
+            },
+        };
+
+        for (auto& corrupt : corruptions) {
+            tmpdir tmp;
+            for (auto& de : fs::directory_iterator(std::string(dir))) {
+                fs::copy(de.path(), tmp.path() / de.path().filename());
+            }
+            auto path = sstable::filename(tmp.path().string(), "ks", "cf", la, generation, big, component_type::Summary);
+            auto [buf, size] = read_file(path).get0();
+            corrupt(buf.get(), size);
+            auto f = open_file_dma(path, open_flags::wo | open_flags::truncate).get0();
+            f.dma_write(0, buf.get(), align_up(size, 512UL)).get();
+            f.truncate(size).get();
+            f.close().get();
+
+            auto sst = env.reusable_sst(uncompressed_schema(), tmp.path().string(), generation).get0();
+            auto& summary = sstables::test(sst).get_summary();
+            BOOST_REQUIRE_EQUAL(summary.positions.size(), summary.header.size);
+            BOOST_REQUIRE_EQUAL(summary.entries.size(), summary.header.size);
+            BOOST_REQUIRE(bytes_view(summary.first_key) == bytes_view(expected.first_key));
+            BOOST_REQUIRE(bytes_view(summary.last_key) == bytes_view(expected.last_key));
+            int idx = 0;
+            for (auto&& e : summary.entries) {
+                auto key = sstables::key::from_bytes(bytes(e.key));
+                BOOST_REQUIRE_EQUAL(sstables::test(sst).binary_search(sst->get_schema()->get_partitioner(), summary.entries, key), idx++);
+            }
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(full_index_search) {
     return test_using_reusable_sst(uncompressed_schema(), uncompressed_dir(), 1, [] (auto sstp) {
         return sstables::test(sstp).read_indexes().then([sstp] (auto index_list) {
@@ -23,6 +23,8 @@
 
 #include "transport/request.hh"
 #include "transport/response.hh"
+#include "transport/segment.hh"
+#include "utils/buffer_input_stream.hh"
 
 #include "test/lib/random_utils.hh"
 
@@ -149,3 +151,60 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     BOOST_CHECK_EQUAL(req.read_short(), 1);
     BOOST_CHECK_EQUAL(req.read_string(), "zed");
 }
+
+SEASTAR_THREAD_TEST_CASE(test_segment_framing_round_trip) {
+    for (auto compression : {cql_transport::cql_compression::none, cql_transport::cql_compression::lz4}) {
+        auto codec = cql_transport::segment_codec(compression);
+        auto writer = cql_transport::segment_writer(codec);
+
+        // Many small envelopes, which should be packed together, and one
+        // which doesn't fit in a single segment.
+        std::vector<bytes> envelopes;
+        for (auto i = 0; i < 1000; ++i) {
+            envelopes.push_back(tests::random::get_bytes(tests::random::get_int<size_t>(1, 300)));
+        }
+        envelopes.push_back(tests::random::get_bytes(3 * cql_transport::segment_codec::max_payload_size + 17));
+        for (auto i = 0; i < 10; ++i) {
+            envelopes.push_back(tests::random::get_bytes(tests::random::get_int<size_t>(1, 300)));
+        }
+
+        bytes_ostream expected;
+        for (auto& e : envelopes) {
+            expected.write(e);
+            bytes_ostream envelope;
+            envelope.write(e);
+            writer.write_envelope(std::move(envelope));
+        }
+        auto segments = writer.segments();
+        auto out = std::move(writer).finish();
+        BOOST_REQUIRE_LT(segments, 10u);
+
+        auto linearized = out.linearize();
+        auto in = cql_transport::make_segment_input_stream(make_buffer_input_stream(
+                temporary_buffer<char>(reinterpret_cast<const char*>(linearized.data()), linearized.size())), compression);
+        auto received = in.read_exactly(expected.size()).get0();
+        BOOST_REQUIRE(bytes_view(reinterpret_cast<const int8_t*>(received.get()), received.size()) == expected.linearize());
+        BOOST_REQUIRE(in.read().get0().empty());
+        in.close().get();
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_framing_detects_corruption) {
+    auto codec = cql_transport::segment_codec(cql_transport::cql_compression::none);
+    auto writer = cql_transport::segment_writer(codec);
+    bytes_ostream envelope;
+    envelope.write(tests::random::get_bytes(100));
+    writer.write_envelope(std::move(envelope));
+    auto out = std::move(writer).finish();
+
+    // Flip a bit in the header and in the payload respectively.
+    for (size_t pos : {size_t(1), cql_transport::segment_codec::uncompressed_header_size + 10}) {
+        auto v = out.linearize();
+        auto corrupted = bytes(v.data(), v.size());
+        corrupted[pos] ^= 0x1;
+        auto in = cql_transport::make_segment_input_stream(make_buffer_input_stream(
+                temporary_buffer<char>(reinterpret_cast<const char*>(corrupted.data()), corrupted.size())), cql_transport::cql_compression::none);
+        BOOST_REQUIRE_THROW(in.read().get(), cql_transport::cql_segment_error);
+        in.close().get();
+    }
+}
@@ -51,7 +51,8 @@ void test_serialized_size_from_first_byte<unsigned_vint>(vint_size_type size, by
 // Check that the encoded value decodes back to the value. Also allows inspecting the encoded bytes.
 template <class Vint, class BytesInspector>
 void check_bytes_and_roundtrip(typename Vint::value_type value, BytesInspector&& f) {
-    static std::array<int8_t, 9> encoding_buffer({});
+    // Leaves room for the bytes following the vint in a buffer.
+    static std::array<int8_t, 2 * max_vint_length> encoding_buffer({});
 
     const auto size = Vint::serialize(value, encoding_buffer.begin());
     const auto view = bytes_view(encoding_buffer.data(), size);
@@ -60,6 +61,12 @@ void check_bytes_and_roundtrip(typename Vint::value_type value, BytesInspector&&
     const auto deserialized = Vint::deserialize(view);
     BOOST_REQUIRE_EQUAL(deserialized, value);
     test_serialized_size_from_first_byte<Vint>(size, view);
+
+    for (auto v : {view, bytes_view(encoding_buffer.data(), encoding_buffer.size())}) {
+        const auto with_size = Vint::deserialize_with_size(v);
+        BOOST_REQUIRE_EQUAL(with_size.value, value);
+        BOOST_REQUIRE_EQUAL(with_size.size, size);
+    }
 };
 
 // Check that the encoded value decodes back to the value.
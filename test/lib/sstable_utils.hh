@@ -136,7 +136,7 @@ class test {
         return _sst->read_summary(default_priority_class());
     }
 
-    future<summary_entry&> read_summary_entry(size_t i) {
+    future<summary_entry> read_summary_entry(size_t i) {
         return _sst->read_summary_entry(i);
     }
 
@@ -183,15 +183,33 @@ static mutation make_mutation(schema_ptr s, mutation_settings settings) {
     return m;
 }
 
+// Memory held by an open sstable for its Summary and Filter.
+struct sstable_memory {
+    size_t summary;
+    // The summary with a separately allocated object per entry, as laid out before it was packed.
+    size_t unpacked_summary;
+    size_t filter;
+};
+
 struct sizes {
     size_t memtable;
     size_t cache;
     std::map<sstables::sstable::version_types, size_t> sstable;
+    std::map<sstables::sstable::version_types, sstable_memory> open_sstable;
     size_t frozen;
     size_t canonical;
     size_t query_result;
 };
 
+static size_t unpacked_summary_footprint(const sstables::summary& s) {
+    size_t sz = sizeof(s) + sizeof(uint32_t) * s.positions.size() + s.first_key.value.size() + s.last_key.value.size();
+    for (auto&& e : s.entries) {
+        // Each entry kept its key and the serialized form of its token apart from the entry.
+        sz += sizeof(sstables::summary_entry) + e.key.size() + sizeof(int64_t);
+    }
+    return sz;
+}
+
 static sizes calculate_sizes(cache_tracker& tracker, const mutation_settings& settings) {
     sizes result;
     auto s = make_schema(settings);
@@ -229,6 +247,11 @@ static sizes calculate_sizes(cache_tracker& tracker, const mutation_settings& se
             write_memtable_to_sstable_for_test(*mt2, sst).get();
             sst->load().get();
             result.sstable[v] = sst->data_size();
+            result.open_sstable[v] = sstable_memory{
+                sst->get_summary().memory_footprint(),
+                unpacked_summary_footprint(sst->get_summary()),
+                sst->filter_memory_size(),
+            };
         }
     }).get();
 
@@ -277,6 +300,10 @@ int main(int argc, char** argv) {
             for (auto v : sizes.sstable) {
                 std::cout << "   " << sstables::to_string(v.first) << ":   " << v.second << "\n";
             }
+            std::cout << " - open sstable memory (summary, summary before packing, filter):\n";
+            for (auto& [v, m] : sizes.open_sstable) {
+                std::cout << "   " << sstables::to_string(v) << ":   " << m.summary << ", " << m.unpacked_summary << ", " << m.filter << "\n";
+            }
             std::cout << " - frozen:       " << sizes.frozen << "\n";
             std::cout << " - canonical:    " << sizes.canonical << "\n";
             std::cout << " - query result: " << sizes.query_result << "\n";
@@ -33,6 +33,40 @@
 #include <iosfwd>
 #include <boost/range/irange.hpp>
 
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Counts user-space instructions retired by the calling thread. Reads zero
+// when the kernel doesn't allow access to performance counters (see
+// /proc/sys/kernel/perf_event_paranoid).
+class instructions_counter {
+    int _fd = -1;
+public:
+    instructions_counter() {
+        ::perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    instructions_counter(const instructions_counter&) = delete;
+    ~instructions_counter() {
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+    }
+    uint64_t read() const {
+        uint64_t value = 0;
+        if (_fd < 0 || ::read(_fd, &value, sizeof(value)) != sizeof(value)) {
+            return 0;
+        }
+        return value;
+    }
+};
+
 template <typename Func>
 static
 void time_it(Func func, int iterations = 5, int iterations_between_clock_readings = 1000) {
@@ -65,6 +99,8 @@ class executor {
     const uint64_t _end_at_count;
     const unsigned _n_workers;
     uint64_t _count;
+    instructions_counter _instructions_counter;
+    uint64_t _instructions = 0;
 private:
     future<> run_worker() {
         return do_until([this] {
@@ -86,13 +122,20 @@ class executor {
     // Returns the number of invocations of @func
     future<uint64_t> run() {
         auto idx = boost::irange(0, (int)_n_workers);
+        auto start = _instructions_counter.read();
         return parallel_for_each(idx.begin(), idx.end(), [this] (auto idx) mutable {
             return this->run_worker();
-        }).then([this] {
+        }).then([this, start] {
+            _instructions = _instructions_counter.read() - start;
             return _count;
         });
     }
 
+    // Returns the number of instructions executed by run(), or 0 if unknown
+    uint64_t instructions() const {
+        return _instructions;
+    }
+
     future<> stop() {
         return make_ready_future<>();
     }
@@ -121,9 +164,14 @@ std::vector<double> time_parallel(Func func, unsigned concurrency_per_core, int
         exec.start(concurrency_per_core, func, std::move(end_at), operations_per_shard).get();
         auto total = exec.map_reduce(adder<uint64_t>(), [] (auto& oc) { return oc.run(); }).get0();
         auto end = clk::now();
+        auto instructions = exec.map_reduce(adder<uint64_t>(), [] (auto& oc) { return make_ready_future<uint64_t>(oc.instructions()); }).get0();
         auto duration = std::chrono::duration<double>(end - start).count();
         auto result = static_cast<double>(total) / duration;
-        std::cout << format("{:.2f}", result) << " tps\n";
+        if (instructions && total) {
+            std::cout << format("{:.2f} tps ({:.1f} insns/op)", result, static_cast<double>(instructions) / total) << "\n";
+        } else {
+            std::cout << format("{:.2f}", result) << " tps\n";
+        }
         results.emplace_back(result);
         exec.stop().get();
     }
@@ -23,6 +23,7 @@
 #include "sstables/checksum_utils.hh"
 #include "test/lib/make_random_string.hh"
 #include "utils/gz/crc_combine.hh"
+#include "utils/crc.hh"
 
 #include "seastar/include/seastar/testing/perf_tests.hh"
 
@@ -31,6 +32,8 @@ struct crc_test {
     const sstring data2 = make_random_string(64*1024);
     const uint32_t sum1 = zlib_crc32_checksummer::checksum(data.data(), data.size());
     const uint32_t sum2 = zlib_crc32_checksummer::checksum(data2.data(), data2.size());
+    // The size of a typical commitlog entry.
+    const sstring small_data = make_random_string(512);
 };
 
 PERF_TEST_F(crc_test, perf_deflate_crc32_combine) {
@@ -67,3 +70,20 @@ PERF_TEST_F(crc_test, perf_zlib_crc32_checksum) {
     perf_tests::do_not_optimize(
         zlib_crc32_checksummer::checksum(data.data(), data.size()));
 }
+
+PERF_TEST_F(crc_test, perf_deflate_crc32_checksum_small) {
+    perf_tests::do_not_optimize(
+        libdeflate_crc32_checksummer::checksum(small_data.data(), small_data.size()));
+}
+
+PERF_TEST_F(crc_test, perf_utils_crc32_checksum) {
+    utils::crc32 c;
+    c.process(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    perf_tests::do_not_optimize(c.get());
+}
+
+PERF_TEST_F(crc_test, perf_utils_crc32_checksum_small) {
+    utils::crc32 c;
+    c.process(reinterpret_cast<const uint8_t*>(small_data.data()), small_data.size());
+    perf_tests::do_not_optimize(c.get());
+}
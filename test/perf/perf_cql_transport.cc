@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures the throughput of the CQL transport layer alone, using clients
+// connected over loopback which pipeline OPTIONS requests, so that the
+// backend is not involved.
+
+#include <seastar/core/app-template.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/byteorder.hh>
+#include <seastar/net/api.hh>
+#include <seastar/util/defer.hh>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/perf/perf.hh"
+#include "transport/server.hh"
+#include "transport/response.hh"
+#include "transport/segment.hh"
+#include "db/config.hh"
+#include "timeout_config.hh"
+
+static constexpr uint8_t protocol_version = 4;
+
+struct test_config {
+    unsigned duration_in_seconds;
+    unsigned connections;
+    unsigned pipeline_depth;
+    bool segments;
+    uint16_t port;
+};
+
+class loopback_client {
+    connected_socket _socket;
+    input_stream<char> _in;
+    output_stream<char> _out;
+    std::optional<cql_transport::segment_codec> _codec;
+private:
+    static void write_frame(bytes_ostream& out, uint16_t stream, cql_transport::cql_binary_opcode opcode, bytes_view body) {
+        cql_transport::cql_binary_frame_v3 frame;
+        frame.version = protocol_version;
+        frame.flags = 0;
+        frame.stream = stream;
+        frame.opcode = uint8_t(opcode);
+        frame.length = body.size();
+        frame = net::hton(frame);
+        out.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+        out.write(body);
+    }
+
+    static void write_string(bytes_ostream& out, std::string_view s) {
+        auto len = net::hton(uint16_t(s.size()));
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.write(s.data(), s.size());
+    }
+
+    void send(bytes_ostream out) {
+        for (auto&& fragment : out.fragments()) {
+            _out.write(reinterpret_cast<const char*>(fragment.data()), fragment.size()).get();
+        }
+        _out.flush().get();
+    }
+
+    // Returns the opcode of the response
+    uint8_t read_response() {
+        auto header = _in.read_exactly(sizeof(cql_transport::cql_binary_frame_v3)).get0();
+        if (header.size() != sizeof(cql_transport::cql_binary_frame_v3)) {
+            throw std::runtime_error("connection closed by the server");
+        }
+        auto frame = net::ntoh(*reinterpret_cast<const cql_transport::cql_binary_frame_v3*>(header.get()));
+        _in.skip(frame.length).get();
+        return frame.opcode;
+    }
+public:
+    explicit loopback_client(connected_socket socket)
+        : _socket(std::move(socket))
+        , _in(_socket.input())
+        , _out(_socket.output())
+    { }
+
+    void startup(bool segments) {
+        bytes_ostream body;
+        auto options = std::map<sstring, sstring>{{"CQL_VERSION", "3.0.0"}};
+        if (segments) {
+            options.emplace(cql_transport::protocol_extension_name(cql_transport::cql_protocol_extension::SEGMENT_FRAMING), "");
+        }
+        auto n = net::hton(uint16_t(options.size()));
+        body.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        for (auto& [key, value] : options) {
+            write_string(body, key);
+            write_string(body, value);
+        }
+        bytes_ostream out;
+        write_frame(out, 0, cql_transport::cql_binary_opcode::STARTUP, body.linearize());
+        send(std::move(out));
+        if (read_response() != uint8_t(cql_transport::cql_binary_opcode::READY)) {
+            throw std::runtime_error("STARTUP failed");
+        }
+        if (segments) {
+            _codec.emplace(cql_transport::cql_compression::none);
+            _in = cql_transport::make_segment_input_stream(std::move(_in), cql_transport::cql_compression::none);
+        }
+    }
+
+    // Sends n pipelined requests with a single write and waits for all responses.
+    void run_batch(unsigned n) {
+        bytes_ostream out;
+        if (_codec) {
+            cql_transport::segment_writer writer(*_codec);
+            for (unsigned stream = 0; stream < n; ++stream) {
+                bytes_ostream envelope;
+                write_frame(envelope, stream, cql_transport::cql_binary_opcode::OPTIONS, bytes_view());
+                writer.write_envelope(std::move(envelope));
+            }
+            out = std::move(writer).finish();
+        } else {
+            for (unsigned stream = 0; stream < n; ++stream) {
+                write_frame(out, stream, cql_transport::cql_binary_opcode::OPTIONS, bytes_view());
+            }
+        }
+        send(std::move(out));
+        for (unsigned i = 0; i < n; ++i) {
+            read_response();
+        }
+    }
+
+    void close() {
+        _out.close().get();
+        _in.close().get();
+    }
+};
+
+static uint64_t run_clients(const test_config& cfg) {
+    auto addr = socket_address(ipv4_addr("127.0.0.1", cfg.port));
+    auto end_at = lowres_clock::now() + std::chrono::seconds(1);
+    std::vector<future<uint64_t>> clients;
+    for (unsigned i = 0; i < cfg.connections; ++i) {
+        clients.push_back(seastar::async([&cfg, addr, end_at] {
+            auto client = loopback_client(connect(addr).get0());
+            client.startup(cfg.segments);
+            uint64_t requests = 0;
+            while (lowres_clock::now() < end_at) {
+                client.run_batch(cfg.pipeline_depth);
+                requests += cfg.pipeline_depth;
+            }
+            client.close();
+            return requests;
+        }));
+    }
+    uint64_t total = 0;
+    for (auto& f : clients) {
+        total += f.get0();
+    }
+    return total;
+}
+
+static void run_test(cql_test_env& env, const test_config& cfg) {
+    sharded<cql_transport::cql_server> server;
+    cql_transport::cql_server_config server_cfg;
+    server_cfg.timeout_config = make_timeout_config(env.local_db().get_config());
+    server_cfg.max_request_size = 100 << 20;
+    server_cfg.get_service_memory_limiter_semaphore = [] () -> semaphore& {
+        static thread_local semaphore sem(100 << 20);
+        return sem;
+    };
+    server_cfg.partitioner_name = env.local_db().get_config().partitioner();
+    server.start(std::ref(env.qp()),
+            sharded_parameter([&env] { return std::ref(env.local_auth_service()); }),
+            sharded_parameter([&env] { return std::ref(env.local_mnotifier()); }),
+            std::ref(env.db()), server_cfg).get();
+    auto stop_server = defer([&server] { server.stop().get(); });
+    server.invoke_on_all(&cql_transport::cql_server::listen,
+            socket_address(ipv4_addr("127.0.0.1", cfg.port)), std::shared_ptr<seastar::tls::credentials_builder>(), false, false).get();
+
+    for (unsigned i = 0; i < cfg.duration_in_seconds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        auto shards = boost::irange(0u, smp::count);
+        auto total = map_reduce(shards.begin(), shards.end(), [&cfg] (unsigned shard) {
+            return smp::submit_to(shard, [&cfg] {
+                return seastar::async([&cfg] {
+                    return run_clients(cfg);
+                });
+            });
+        }, uint64_t(0), std::plus<uint64_t>()).get0();
+        auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << format("{:.2f}", total / duration) << " requests/s\n";
+    }
+
+    auto flushes = server.map_reduce0([] (const cql_transport::cql_server& s) { return s.get_stats().response_flushes; }, uint64_t(0), std::plus<uint64_t>()).get0();
+    auto responses = server.map_reduce0([] (const cql_transport::cql_server& s) { return s.get_stats().responses_flushed; }, uint64_t(0), std::plus<uint64_t>()).get0();
+    auto bytes = server.map_reduce0([] (const cql_transport::cql_server& s) { return s.get_stats().response_bytes_flushed; }, uint64_t(0), std::plus<uint64_t>()).get0();
+    std::cout << format("responses per flush: {:.2f}\nbytes per flush: {:.2f}\n",
+            double(responses) / std::max<uint64_t>(flushes, 1), double(bytes) / std::max<uint64_t>(flushes, 1));
+}
+
+int main(int argc, char** argv) {
+    namespace bpo = boost::program_options;
+    app_template app;
+    app.add_options()
+        ("duration", bpo::value<unsigned>()->default_value(5), "test duration in seconds")
+        ("connections", bpo::value<unsigned>()->default_value(4), "client connections per core")
+        ("pipeline-depth", bpo::value<unsigned>()->default_value(128), "requests in flight per connection")
+        ("segments", "use segment framing (the SCYLLA_SEGMENT_FRAMING protocol extension)")
+        ("port", bpo::value<uint16_t>()->default_value(19043), "port to listen on for CQL connections")
+        ;
+
+    return app.run(argc, argv, [&app] {
+        return do_with_cql_env_thread([&app] (cql_test_env& env) {
+            auto cfg = test_config();
+            cfg.duration_in_seconds = app.configuration()["duration"].as<unsigned>();
+            cfg.connections = app.configuration()["connections"].as<unsigned>();
+            cfg.pipeline_depth = app.configuration()["pipeline-depth"].as<unsigned>();
+            cfg.segments = app.configuration().contains("segments");
+            cfg.port = app.configuration()["port"].as<uint16_t>();
+            run_test(env, cfg);
+        });
+    });
+}
@@ -1768,6 +1768,8 @@ int main(int argc, char** argv) {
         ("keep-cache-across-test-groups", "Clears the cache between test groups")
         ("keep-cache-across-test-cases", "Clears the cache between test cases in each test group")
         ("with-compression", "Generates compressed sstables")
+        ("with-partition-trie", "Generates sstables with a trie of the partition keys, used by single-partition reads")
+        ("partition-trie-cache-size-in-kb", bpo::value<uint32_t>()->default_value(64), "Memory per sstable for caching the pages of its partition trie")
         ("rows", bpo::value<int>()->default_value(1000000), "Number of CQL rows in a partition. Relevant only for population.")
         ("value-size", bpo::value<int>()->default_value(100), "Size of value stored in a cell. Relevant only for population.")
         ("name", bpo::value<std::string>()->default_value("default"), "Name of the configuration")
@@ -1814,6 +1816,8 @@ int main(int argc, char** argv) {
         db_cfg.enable_commitlog(false);
         db_cfg.data_file_directories({datadir}, db::config::config_source::CommandLine);
         db_cfg.virtual_dirty_soft_limit(1.0); // prevent background memtable flushes.
+        db_cfg.enable_sstable_partition_trie(app.configuration().contains("with-partition-trie"));
+        db_cfg.sstable_partition_trie_cache_size_in_kb(app.configuration()["partition-trie-cache-size-in-kb"].as<uint32_t>());
 
         auto sstable_format_name = app.configuration()["sstable-format"].as<std::string>();
         if (sstable_format_name == "md") {
@@ -71,6 +71,7 @@ struct test_config {
     bool counters;
     bool flush_memtables;
     unsigned operations_per_shard = 0;
+    bool bounce;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -88,9 +89,23 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", mode=" << cfg.mode
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", bounce=" << (cfg.bounce ? "yes" : "no")
            << "}";
 }
 
+// With --bounce, each request is executed on the next shard, the way the CQL
+// server forwards requests which have to be executed on another shard (e.g.
+// LWT). Comparing the results with and without --bounce shows the cost of
+// the cross-shard hop.
+static future<> execute_prepared(cql_test_env& env, const test_config& cfg, cql3::prepared_cache_key_type id, bytes key) {
+    if (!cfg.bounce) {
+        return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+    }
+    return smp::submit_to((this_shard_id() + 1) % smp::count, [&env, id = std::move(id), key = std::move(key)] () mutable {
+        return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+    });
+}
+
 static void create_partitions(cql_test_env& env, test_config& cfg) {
     std::cout << "Creating " << cfg.partitions << " partitions..." << std::endl;
     for (unsigned sequence = 0; sequence < cfg.partitions; ++sequence) {
@@ -112,7 +127,7 @@ static std::vector<double> test_read(cql_test_env& env, test_config& cfg) {
     auto id = env.prepare("select \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" from cf where \"KEY\" = ?").get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_key(cfg.query_single_key ? 0 : std::rand() % cfg.partitions);
-            return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+            return execute_prepared(env, cfg, id, std::move(key));
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
 }
 
@@ -126,7 +141,7 @@ static std::vector<double> test_write(cql_test_env& env, test_config& cfg) {
                            "WHERE \"KEY\" = ?;").get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_key(cfg.query_single_key ? 0 : std::rand() % cfg.partitions);
-            return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+            return execute_prepared(env, cfg, id, std::move(key));
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
 }
 
@@ -135,7 +150,7 @@ static std::vector<double> test_delete(cql_test_env& env, test_config& cfg) {
     auto id = env.prepare("DELETE \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" FROM cf WHERE \"KEY\" = ?").get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_key(cfg.query_single_key ? 0 : std::rand() % cfg.partitions);
-            return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+            return execute_prepared(env, cfg, id, std::move(key));
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
 }
 
@@ -149,7 +164,7 @@ static std::vector<double> test_counter_update(cql_test_env& env, test_config& c
                            "WHERE \"KEY\" = ?;").get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_key(cfg.query_single_key ? 0 : std::rand() % cfg.partitions);
-            return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+            return execute_prepared(env, cfg, id, std::move(key));
         }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
 }
 
@@ -201,6 +216,7 @@ void write_json_result(std::string result_file, const test_config& cfg, double m
     params["partitions"] = cfg.partitions;
     params["cpus"] = smp::count;
     params["duration"] = cfg.duration_in_seconds;
+    params["bounce"] = cfg.bounce;
     params["concurrency,partitions,cpus,duration"] = fmt::format("{},{},{},{}", cfg.concurrency, cfg.partitions, smp::count, cfg.duration_in_seconds);
     results["parameters"] = std::move(params);
 
@@ -263,6 +279,7 @@ int main(int argc, char** argv) {
         ("counters", "test counters")
         ("flush", "flush memtables before test")
         ("json-result", bpo::value<std::string>(), "name of the json result file")
+        ("bounce", "execute each request on another shard, to measure the cost of forwarding requests between shards")
         ;
 
     set_abort_on_internal_error(true);
@@ -282,6 +299,7 @@ int main(int argc, char** argv) {
             cfg.query_single_key = app.configuration().contains("query-single-key");
             cfg.counters = app.configuration().contains("counters");
             cfg.flush_memtables = app.configuration().contains("flush");
+            cfg.bounce = app.configuration().contains("bounce");
             if (app.configuration().contains("write")) {
                 cfg.mode = test_config::run_mode::write;
             } else if (app.configuration().contains("delete")) {
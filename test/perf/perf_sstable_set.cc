@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <random>
+
+#include <boost/range/adaptor/transformed.hpp>
+
+#include "seastar/include/seastar/testing/perf_tests.hh"
+#include <seastar/testing/test_runner.hh>
+#include <seastar/core/memory.hh>
+
+#include "sstables/sstable_set.hh"
+#include "sstables/compaction_strategy.hh"
+#include "schema_builder.hh"
+#include "test/lib/sstable_test_env.hh"
+#include "test/lib/sstable_utils.hh"
+
+// Selection from a set of many overlapping sstables, as left by STCS or by
+// level 0 of LCS falling behind.
+class sstable_set_fixture {
+public:
+    static constexpr size_t sstable_count = 4096;
+    static constexpr size_t key_count = 16384;
+    // Largest number of keys spanned by a sstable.
+    static constexpr size_t max_sstable_span = 64;
+    static constexpr size_t lookups = 1000;
+private:
+    sstables::test_env _env;
+    schema_ptr _schema;
+    std::vector<std::pair<sstring, dht::token>> _keys;
+    std::vector<dht::decorated_key> _decorated_keys;
+    std::vector<sstables::shared_sstable> _sstables;
+    std::optional<sstables::sstable_set> _set;
+    sstables::shared_sstable _extra;
+    std::vector<size_t> _lookup_keys;
+private:
+    sstables::shared_sstable make_sstable(int64_t generation, size_t first, size_t last) {
+        auto sst = _env.make_sstable(_schema, "", generation, sstables::sstable::version_types::la, sstables::sstable::format_types::big);
+        sstables::test(sst).set_values_for_leveled_strategy(0, 0, 0, _keys[first].first, _keys[last].first);
+        return sst;
+    }
+public:
+    sstable_set_fixture()
+        : _schema(schema_builder("ks", "perf_sstable_set")
+                .with_column("p1", utf8_type, column_kind::partition_key)
+                .with_column("v", utf8_type)
+                .build())
+        , _keys(token_generation_for_current_shard(key_count))
+    {
+        _decorated_keys = boost::copy_range<std::vector<dht::decorated_key>>(_keys | boost::adaptors::transformed([this] (auto& key_and_token) {
+            auto value = bytes(reinterpret_cast<const signed char*>(key_and_token.first.data()), key_and_token.first.size());
+            auto pk = sstables::key::from_bytes(value).to_partition_key(*_schema);
+            return dht::decorate_key(*_schema, std::move(pk));
+        }));
+
+        auto eng = seastar::testing::local_random_engine;
+        auto first_dist = std::uniform_int_distribution<size_t>(0, key_count - 1);
+        auto span_dist = std::uniform_int_distribution<size_t>(0, max_sstable_span - 1);
+        for (size_t i = 0; i < sstable_count; i++) {
+            auto first = first_dist(eng);
+            _sstables.push_back(make_sstable(i + 1, first, std::min(first + span_dist(eng), key_count - 1)));
+        }
+        _extra = make_sstable(sstable_count + 1, 0, max_sstable_span);
+        std::generate_n(std::back_inserter(_lookup_keys), lookups, [&] { return first_dist(eng); });
+
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, {});
+        auto allocated_before = memory::stats().allocated_memory();
+        _set.emplace(cs.make_sstable_set(_schema));
+        for (auto& sst : _sstables) {
+            _set->insert(sst);
+        }
+        auto allocated_after = memory::stats().allocated_memory();
+        std::cout << format("sstable_set: {} sstables, {:.1f} bytes per sstable\n",
+                sstable_count, double(allocated_after - allocated_before) / sstable_count);
+    }
+
+    ~sstable_set_fixture() {
+        _set.reset();
+        _sstables.clear();
+        _extra = {};
+        _env.stop().get();
+    }
+
+    const sstables::sstable_set& set() const {
+        return *_set;
+    }
+
+    const dht::decorated_key& key(size_t i) const {
+        return _decorated_keys[i];
+    }
+
+    const std::vector<size_t>& lookup_keys() const {
+        return _lookup_keys;
+    }
+
+    const sstables::shared_sstable& extra_sstable() const {
+        return _extra;
+    }
+};
+
+PERF_TEST_F(sstable_set_fixture, select_single_partition) {
+    for (auto i : lookup_keys()) {
+        perf_tests::do_not_optimize(set().select(dht::partition_range::make_singular(key(i))));
+    }
+    return lookups;
+}
+
+PERF_TEST_F(sstable_set_fixture, select_range) {
+    for (auto i : lookup_keys()) {
+        auto end = std::min(i + max_sstable_span, key_count - 1);
+        perf_tests::do_not_optimize(set().select(dht::partition_range::make({key(i), true}, {key(end), true})));
+    }
+    return lookups;
+}
+
+PERF_TEST_F(sstable_set_fixture, incremental_selector_scan) {
+    auto selector = set().make_incremental_selector();
+    for (size_t i = 0; i < key_count; i++) {
+        perf_tests::do_not_optimize(selector.select(key(i)).sstables);
+    }
+    return key_count;
+}
+
+// Every sstable list update copies the set and inserts into the copy.
+PERF_TEST_F(sstable_set_fixture, copy_and_insert) {
+    auto copy = set();
+    copy.insert(extra_sstable());
+    perf_tests::do_not_optimize(copy);
+    return 1;
+}
@@ -50,7 +50,7 @@ class vint {
     }
 
     const std::vector<uint64_t>& integers() const { return _integers; }
-    bytes_view serialized() const { return bytes_view(_serialized.data()); }
+    bytes_view serialized() const { return bytes_view(_serialized.data(), _serialized.size()); }
 };
 
 PERF_TEST_F(vint, serialize) {
@@ -72,3 +72,13 @@ PERF_TEST_F(vint, deserialize) {
     }
     return count;
 }
+
+PERF_TEST_F(vint, deserialize_with_size) {
+    auto src = serialized();
+    for (auto i = 0u; i < count; i++) {
+        auto [value, len] = unsigned_vint::deserialize_with_size(src);
+        perf_tests::do_not_optimize(value);
+        src.remove_prefix(len);
+    }
+    return count;
+}
@@ -67,6 +67,33 @@ void list_partitions(const schema& s, sstables::index_reader& idx_reader) {
     silog.debug("done with index");
 }
 
+// Looks up every partition of the sstable through its partition trie.
+void check_partition_trie(const schema& s, sstables::shared_sstable sst) {
+    if (!sst->has_partition_trie()) {
+        throw std::invalid_argument(fmt::format("error: sstable {} has no partition trie", sst->get_filename()));
+    }
+    std::vector<dht::decorated_key> keys;
+    {
+        sstables::index_reader idx_reader(sst, rcs_sem.make_permit(&s, "idx"), default_priority_class(), {});
+        while (!idx_reader.eof()) {
+            idx_reader.read_partition_data().get();
+            keys.push_back(dht::decorate_key(s, idx_reader.current_partition_entry().get_key().to_partition_key(s)));
+            idx_reader.advance_to_next_partition().get();
+        }
+        idx_reader.close().get();
+    }
+    size_t missing = 0;
+    for (const auto& dk : keys) {
+        sstables::index_reader idx_reader(sst, rcs_sem.make_permit(&s, "trie"), default_priority_class(), {});
+        if (!idx_reader.advance_lower_and_check_if_present(dk).get0()) {
+            fmt::print("not found through the partition trie: {}\n", dk);
+            ++missing;
+        }
+        idx_reader.close().get();
+    }
+    fmt::print("{} partitions, {} not found through the partition trie\n", keys.size(), missing);
+}
+
 }
 
 int main(int argc, char** argv) {
@@ -119,6 +146,10 @@ Types that takes other types as parameters, like collections can be written as:
 Don't forget to quote such expressions when passing on the command line.
 
 Note: UDT is not supported for now.
+
+With `--check-partition-trie`, instead of listing the partitions, the
+tool looks up each of them through the partition trie (the Partitions.db
+component) of the sstable and reports those which it doesn't find.
 )";
 
     app_template app(std::move(app_cfg));
@@ -126,6 +157,7 @@ Note: UDT is not supported for now.
     app.add_options()
         ("type,t", bpo::value<std::vector<sstring>>(), "the types making up the partition key, if the partition key is compound, list all types"
                 " in it in order; types have to be specified in Cassandra class notation, see description for more details")
+        ("check-partition-trie", "look up every partition through the partition trie of the sstable instead of listing them")
         ;
 
     app.add_positional_options({
@@ -173,7 +205,9 @@ Note: UDT is not supported for now.
 
             sst->load().get();
 
-            {
+            if (app.configuration().contains("check-partition-trie")) {
+                check_partition_trie(*primary_key_schema, sst);
+            } else {
                 sstables::index_reader idx_reader(sst, rcs_sem.make_permit(primary_key_schema.get(), "idx"), default_priority_class(), {});
 
                 list_partitions(*primary_key_schema, idx_reader);
@@ -94,6 +94,14 @@ class response {
     // Make a non-owning scattered_message of the response. Remains valid as long
     // as the response object is alive.
     scattered_message<char> make_message(uint8_t version, cql_compression compression);
+    // Like make_message(), but appends to an existing message, so that
+    // several responses can be sent with a single write.
+    void append_to_message(scattered_message<char>& msg, uint8_t version, cql_compression compression);
+
+    // Appends the response, framed as an uncompressed envelope, to `out`.
+    // Used when the connection has switched to segment framing, in which
+    // case compression is applied to whole segments.
+    void write_envelope(uint8_t version, bytes_ostream& out) const;
 
     cql_binary_opcode opcode() const {
         return _opcode;
@@ -107,7 +115,7 @@ class response {
     void compress_snappy();
 
     template <typename CqlFrameHeaderType>
-    sstring make_frame_one(uint8_t version, size_t length) {
+    sstring make_frame_one(uint8_t version, size_t length) const {
         sstring frame_buf = uninitialized_string(sizeof(CqlFrameHeaderType));
         auto* frame = reinterpret_cast<CqlFrameHeaderType*>(frame_buf.data());
         frame->version = version | 0x80;
@@ -119,7 +127,7 @@ class response {
         return frame_buf;
     }
 
-    sstring make_frame(uint8_t version, size_t length) {
+    sstring make_frame(uint8_t version, size_t length) const {
         if (version > 0x04) {
             throw exceptions::protocol_exception(format("Invalid or unsupported protocol version: {:d}", version));
         }
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "transport/segment.hh"
+#include "transport/server.hh"
+#include "exceptions/exceptions.hh"
+
+#include <seastar/core/print.hh>
+
+#include <cassert>
+
+#include <lz4.h>
+#include "libdeflate/libdeflate.h"
+
+namespace cql_transport {
+
+// CRC24 as used by the segment header; see native_protocol_v5.spec.
+static constexpr uint32_t crc24_init = 0x875060;
+static constexpr uint32_t crc24_poly = 0x1974F0B;
+
+static uint32_t crc24(uint64_t bytes, unsigned len) {
+    uint32_t crc = crc24_init;
+    while (len--) {
+        crc ^= (bytes & 0xff) << 16;
+        bytes >>= 8;
+        for (unsigned i = 0; i < 8; ++i) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= crc24_poly;
+            }
+        }
+    }
+    return crc & 0xffffff;
+}
+
+// The payload CRC32 is seeded with these bytes, so that an all-zero payload
+// doesn't have an all-zero checksum.
+static uint32_t payload_crc32(const char* p, size_t size) {
+    static const char initial_bytes[] = { char(0xfa), char(0x2d), char(0x55), char(0xca) };
+    auto crc = libdeflate_crc32(0, initial_bytes, sizeof(initial_bytes));
+    return libdeflate_crc32(crc, p, size);
+}
+
+static void write_le(char* p, uint64_t v, unsigned len) {
+    for (unsigned i = 0; i < len; ++i) {
+        p[i] = char(v & 0xff);
+        v >>= 8;
+    }
+}
+
+static uint64_t read_le(const char* p, unsigned len) {
+    uint64_t v = 0;
+    for (unsigned i = len; i > 0; --i) {
+        v = (v << 8) | uint8_t(p[i - 1]);
+    }
+    return v;
+}
+
+segment_codec::segment_codec(cql_compression compression)
+    : _compressed(compression == cql_compression::lz4)
+{
+    if (compression != cql_compression::none && compression != cql_compression::lz4) {
+        throw exceptions::protocol_exception("Segment framing supports only LZ4 compression");
+    }
+}
+
+void segment_codec::encode(bytes_view payload, bool self_contained, bytes_ostream& out) const {
+    assert(payload.size() <= max_payload_size);
+    auto input = reinterpret_cast<const char*>(payload.data());
+
+    if (!_compressed) {
+        uint64_t hdr = payload.size();
+        if (self_contained) {
+            hdr |= uint64_t(1) << 17;
+        }
+        auto p = reinterpret_cast<char*>(out.write_place_holder(uncompressed_header_size));
+        write_le(p, hdr, 3);
+        write_le(p + 3, crc24(hdr, 3), 3);
+        out.write(payload);
+        p = reinterpret_cast<char*>(out.write_place_holder(trailer_size));
+        write_le(p, payload_crc32(input, payload.size()), trailer_size);
+        return;
+    }
+
+    auto bound = LZ4_compressBound(payload.size());
+    auto p = reinterpret_cast<char*>(out.write_place_holder(compressed_header_size + bound + trailer_size));
+    auto data = p + compressed_header_size;
+#ifdef HAVE_LZ4_COMPRESS_DEFAULT
+    auto ret = LZ4_compress_default(input, data, payload.size(), bound);
+#else
+    auto ret = LZ4_compress(input, data, payload.size());
+#endif
+    if (ret <= 0) {
+        throw std::runtime_error("CQL segment LZ4 compression failure");
+    }
+    size_t compressed_size = ret;
+    size_t uncompressed_size = payload.size();
+    if (compressed_size >= payload.size()) {
+        // Compression didn't help, ship the payload as is. An uncompressed
+        // size of zero tells the reader not to decompress.
+        std::copy_n(input, payload.size(), data);
+        compressed_size = payload.size();
+        uncompressed_size = 0;
+    }
+    uint64_t hdr = compressed_size | (uint64_t(uncompressed_size) << 17);
+    if (self_contained) {
+        hdr |= uint64_t(1) << 34;
+    }
+    write_le(p, hdr, 5);
+    write_le(p + 5, crc24(hdr, 5), 3);
+    write_le(data + compressed_size, payload_crc32(data, compressed_size), trailer_size);
+    out.remove_suffix(bound - compressed_size);
+}
+
+segment_codec::header segment_codec::decode_header(const char* p) const {
+    header h;
+    if (!_compressed) {
+        auto hdr = read_le(p, 3);
+        auto crc = read_le(p + 3, 3);
+        if (crc != crc24(hdr, 3)) {
+            throw cql_segment_error("CQL segment header checksum mismatch");
+        }
+        h.payload_size = hdr & 0x1ffff;
+        h.uncompressed_size = h.payload_size;
+        h.self_contained = hdr & (uint64_t(1) << 17);
+        return h;
+    }
+    auto hdr = read_le(p, 5);
+    auto crc = read_le(p + 5, 3);
+    if (crc != crc24(hdr, 5)) {
+        throw cql_segment_error("CQL segment header checksum mismatch");
+    }
+    h.payload_size = hdr & 0x1ffff;
+    h.uncompressed_size = (hdr >> 17) & 0x1ffff;
+    if (!h.uncompressed_size) {
+        h.uncompressed_size = h.payload_size;
+    }
+    h.self_contained = hdr & (uint64_t(1) << 34);
+    return h;
+}
+
+temporary_buffer<char> segment_codec::decode_payload(const header& h, temporary_buffer<char> body) const {
+    if (body.size() != h.payload_size + trailer_size) {
+        throw cql_segment_error(format("Truncated CQL segment: expected {:d} bytes, got {:d}", h.payload_size + trailer_size, body.size()));
+    }
+    auto crc = read_le(body.get() + h.payload_size, trailer_size);
+    if (crc != payload_crc32(body.get(), h.payload_size)) {
+        throw cql_segment_error("CQL segment payload checksum mismatch");
+    }
+    body.trim(h.payload_size);
+    if (h.uncompressed_size == h.payload_size) {
+        return body;
+    }
+    temporary_buffer<char> out(h.uncompressed_size);
+    auto ret = LZ4_decompress_safe(body.get(), out.get_write(), body.size(), out.size());
+    if (ret < 0 || size_t(ret) != out.size()) {
+        throw cql_segment_error("CQL segment LZ4 uncompression failure");
+    }
+    return out;
+}
+
+void segment_writer::flush_pending() {
+    if (_pending.empty()) {
+        return;
+    }
+    _codec.encode(_pending.linearize(), true, _out);
+    _pending.clear();
+    ++_segments;
+}
+
+void segment_writer::write_envelope(bytes_ostream envelope) {
+    if (_pending.size() + envelope.size() > segment_codec::max_payload_size) {
+        flush_pending();
+    }
+    if (envelope.size() <= segment_codec::max_payload_size) {
+        _pending.append(envelope);
+        return;
+    }
+    // A large envelope is split across several segments, none of which
+    // is self-contained.
+    auto v = envelope.linearize();
+    while (!v.empty()) {
+        auto chunk = v.substr(0, segment_codec::max_payload_size);
+        _codec.encode(chunk, false, _out);
+        v.remove_prefix(chunk.size());
+        ++_segments;
+    }
+}
+
+bytes_ostream segment_writer::finish() && {
+    flush_pending();
+    return std::move(_out);
+}
+
+class segment_data_source_impl final : public data_source_impl {
+    input_stream<char> _in;
+    segment_codec _codec;
+public:
+    segment_data_source_impl(input_stream<char> in, cql_compression compression)
+        : _in(std::move(in))
+        , _codec(compression)
+    { }
+
+    virtual future<temporary_buffer<char>> get() override {
+        return _in.read_exactly(_codec.header_size()).then([this] (temporary_buffer<char> hdr) {
+            if (hdr.empty()) {
+                return make_ready_future<temporary_buffer<char>>();
+            }
+            if (hdr.size() != _codec.header_size()) {
+                throw cql_segment_error("Truncated CQL segment header");
+            }
+            auto h = _codec.decode_header(hdr.get());
+            return _in.read_exactly(h.payload_size + segment_codec::trailer_size).then([this, h] (temporary_buffer<char> body) {
+                auto payload = _codec.decode_payload(h, std::move(body));
+                if (payload.empty()) {
+                    // An empty buffer means end-of-stream to our consumer.
+                    return get();
+                }
+                return make_ready_future<temporary_buffer<char>>(std::move(payload));
+            });
+        });
+    }
+
+    virtual future<> close() override {
+        return _in.close();
+    }
+};
+
+input_stream<char> make_segment_input_stream(input_stream<char> in, cql_compression compression) {
+    return input_stream<char>(data_source(std::make_unique<segment_data_source_impl>(std::move(in), compression)));
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <seastar/core/iostream.hh>
+#include <seastar/core/temporary_buffer.hh>
+
+#include "bytes.hh"
+#include "bytes_ostream.hh"
+#include "seastarx.hh"
+
+namespace cql_transport {
+
+enum class cql_compression;
+
+struct cql_segment_error : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+/*
+ * Segment framing, as defined by native_protocol_v5.spec, section 2.
+ *
+ * Once negotiated, the connection stops exchanging bare frames (envelopes)
+ * and instead exchanges segments. Each segment carries a payload of up to
+ * max_payload_size bytes, protected by a CRC24 over the header and a CRC32
+ * over the payload. The payload is either a sequence of one or more complete
+ * envelopes (a self-contained segment) or a part of a single envelope which
+ * is too large to fit in one segment. When LZ4 compression is in use, it is
+ * applied to the whole segment payload instead of to individual envelopes,
+ * which is much more effective for small messages.
+ */
+class segment_codec {
+    bool _compressed;
+public:
+    static constexpr size_t max_payload_size = 128 * 1024 - 1;
+    static constexpr size_t uncompressed_header_size = 6;
+    static constexpr size_t compressed_header_size = 8;
+    static constexpr size_t trailer_size = 4;
+
+    struct header {
+        // Size of the payload as stored on the wire.
+        size_t payload_size;
+        // Size of the payload after decompression; equal to payload_size
+        // when the payload is not compressed.
+        size_t uncompressed_size;
+        bool self_contained;
+    };
+
+    // Only cql_compression::none and cql_compression::lz4 are allowed.
+    explicit segment_codec(cql_compression compression);
+
+    size_t header_size() const {
+        return _compressed ? compressed_header_size : uncompressed_header_size;
+    }
+
+    // Encodes a single segment containing `payload` and appends it to `out`.
+    void encode(bytes_view payload, bool self_contained, bytes_ostream& out) const;
+
+    // Parses and verifies a segment header of header_size() bytes.
+    header decode_header(const char* p) const;
+
+    // Verifies and decompresses the payload of a segment. `body` must hold
+    // exactly h.payload_size + trailer_size bytes.
+    temporary_buffer<char> decode_payload(const header& h, temporary_buffer<char> body) const;
+};
+
+/*
+ * Packs complete envelopes into as few segments as possible.
+ */
+class segment_writer {
+    const segment_codec& _codec;
+    bytes_ostream _out;
+    bytes_ostream _pending;
+    size_t _segments = 0;
+private:
+    void flush_pending();
+public:
+    explicit segment_writer(const segment_codec& codec) : _codec(codec) { }
+
+    void write_envelope(bytes_ostream envelope);
+
+    size_t segments() const {
+        return _segments;
+    }
+
+    // Returns the encoded segments. The writer must not be used afterwards.
+    bytes_ostream finish() &&;
+};
+
+// Returns an input stream which yields the concatenated payloads of segments
+// read from `in`, i.e. a stream of envelopes.
+input_stream<char> make_segment_input_stream(input_stream<char> in, cql_compression compression);
+
+}
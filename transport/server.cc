@@ -164,6 +164,7 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
     , _config(config)
     , _max_request_size(config.max_request_size)
     , _max_concurrent_requests(db.get_config().max_concurrent_requests_per_shard)
+    , _adaptive_concurrency_limit(db.get_config().cql_adaptive_concurrency_limit)
     , _memory_available(config.get_service_memory_limiter_semaphore())
     , _notifier(std::make_unique<event_notifier>(mn))
     , _auth_service(auth_service)
@@ -218,10 +219,26 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_derive("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
+        sm::make_derive("requests_bounced", _stats.requests_bounced,
+                        sm::description("Holds an incrementing counter with the requests that were forwarded to another shard, e.g. LWT requests received on a shard not owning the partition.")),
+        sm::make_derive("bounced_client_state_copies", _stats.bounced_client_state_copies,
+                        sm::description("Holds an incrementing counter with the number of times the client state of a connection had to be copied to this shard for bounced requests. "
+                                        "Copies are cached per connection, so this should be much lower than the number of bounced requests.")),
         sm::make_gauge("requests_memory_available", [this] { return _memory_available.current(); },
                         sm::description(
                             seastar::format("Holds the amount of available memory for admitting new requests (max is {}B)."
-                                            "Zero value indicates that our bottleneck is memory and more specifically - the memory quota allocated for the \"CQL transport\" component.", _max_request_size)))
+                                            "Zero value indicates that our bottleneck is memory and more specifically - the memory quota allocated for the \"CQL transport\" component.", _max_request_size))),
+
+        sm::make_derive("response_flushes", _stats.response_flushes,
+                        sm::description("Counts the number of writes of CQL responses to client connections. Each write may carry several coalesced responses.")),
+
+        sm::make_derive("responses_flushed", _stats.responses_flushed,
+                        sm::description("Counts the number of CQL responses written to client connections. "
+                                        "Divided by response_flushes, gives the average number of responses per write.")),
+
+        sm::make_derive("response_bytes_flushed", _stats.response_bytes_flushed,
+                        sm::description("Counts the number of bytes of CQL responses written to client connections. "
+                                        "Divided by response_flushes, gives the average number of bytes per write."))
     };
 
     std::vector<sm::metric_definition> transport_metrics;
@@ -242,6 +259,27 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
     }
 
     _metrics.add_group("transport", std::move(transport_metrics));
+
+    _concurrency_limiter_config.min_limit = db.get_config().cql_adaptive_concurrency_limit_min();
+    _concurrency_limiter_config.max_limit = db.get_config().cql_adaptive_concurrency_limit_max();
+}
+
+utils::adaptive_concurrency_limiter& cql_server::get_concurrency_limiter(scheduling_group sg) {
+    auto [it, inserted] = _concurrency_limiters.try_emplace(sg, _concurrency_limiter_config);
+    auto& cl = it->second;
+    if (inserted) {
+        namespace sm = seastar::metrics;
+        auto sg_label = sm::label("scheduling_group_name")(sg.name());
+        cl.metrics.add_group("transport", {
+            sm::make_gauge("adaptive_concurrency_limit", sm::description("Holds the current adaptive limit of concurrent CQL requests (see cql_adaptive_concurrency_limit)."),
+                    {sg_label}, [&l = cl.limiter] { return l.limit(); }),
+            sm::make_gauge("adaptive_concurrency_in_flight", sm::description("Holds the number of CQL requests admitted by the adaptive concurrency limiter which are being processed right now."),
+                    {sg_label}, [&l = cl.limiter] { return l.in_flight(); }),
+            sm::make_derive("requests_shed_adaptive", sm::description("Counts the requests that were shed because they exceeded the adaptive concurrency limit."),
+                    {sg_label}, [&l = cl.limiter] { return l.rejected(); }),
+        });
+    }
+    return cl.limiter;
 }
 
 future<> cql_server::stop() {
@@ -609,6 +647,7 @@ cql_server::connection::connection(cql_server& server, socket_address server_add
     , _read_buf(_fd.input())
     , _write_buf(_fd.output())
     , _client_state(service::client_state::external_tag{}, server._auth_service, server.timeout_config(), addr)
+    , _shard_client_states(smp::count)
 {
     ++_server._total_connections;
     ++_server._current_connections;
@@ -690,6 +729,15 @@ client_data cql_server::connection::make_client_data() const {
 thread_local cql_server::connection::execution_stage_type
         cql_server::connection::_process_request_stage{"transport", &connection::process_request_one};
 
+// Only requests which reach the storage layer are subject to adaptive
+// admission control; the rest are cheap and needed to establish connections.
+static bool is_admission_controlled(uint8_t op) {
+    auto cqlop = static_cast<cql_binary_opcode>(op);
+    return cqlop == cql_binary_opcode::QUERY
+            || cqlop == cql_binary_opcode::EXECUTE
+            || cqlop == cql_binary_opcode::BATCH;
+}
+
 future<> cql_server::connection::process_request() {
     return read_frame().then_wrapped([this] (future<std::optional<cql_binary_frame_v3>>&& v) {
         auto maybe_frame = v.get0();
@@ -730,13 +778,29 @@ future<> cql_server::connection::process_request() {
             });
         }
 
+        utils::adaptive_concurrency_limiter::permit concurrency_permit;
+        if (_server._adaptive_concurrency_limit() && is_admission_controlled(op)) {
+            auto& limiter = _server.get_concurrency_limiter(current_scheduling_group());
+            concurrency_permit = limiter.try_get_permit();
+            if (!concurrency_permit) {
+                ++_server._stats.requests_shed;
+                return _read_buf.skip(f.length).then([this, stream = f.stream, limit = limiter.limit()] {
+                    write_response(make_error(stream, exceptions::exception_code::OVERLOADED,
+                            format("too many in-flight requests (adaptive concurrency limit, enabled via cql_adaptive_concurrency_limit): {}", limit),
+                            tracing::trace_state_ptr()));
+                    return make_ready_future<>();
+                });
+            }
+        }
+
         auto fut = get_units(_server._memory_available, mem_estimate);
         if (_server._memory_available.waiters()) {
             ++_server._stats.requests_blocked_memory;
         }
 
-        return fut.then([this, length = f.length, flags = f.flags, op, stream, tracing_requested] (semaphore_units<> mem_permit) {
-          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit))] (fragmented_temporary_buffer buf) mutable {
+        return fut.then([this, length = f.length, flags = f.flags, op, stream, tracing_requested, concurrency_permit = std::move(concurrency_permit)] (semaphore_units<> mem_permit) mutable {
+          return this->read_and_decompress_frame(length, flags).then([this, op, stream, tracing_requested, mem_permit = make_service_permit(std::move(mem_permit)),
+                                                                      concurrency_permit = std::move(concurrency_permit)] (fragmented_temporary_buffer buf) mutable {
 
             ++_server._stats.requests_served;
             ++_server._stats.requests_serving;
@@ -744,8 +808,13 @@ future<> cql_server::connection::process_request() {
             _pending_requests_gate.enter();
             auto leave = defer([this] { _pending_requests_gate.leave(); });
             auto istream = buf.get_istream();
-            (void)_process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
-                    .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+            auto f = _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
+                    .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), concurrency_permit = std::move(concurrency_permit)]
+                                  (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+                // The request's latency is accounted for by the concurrency
+                // limiter once the response is ready, not when it's written,
+                // as the latter depends on the client.
+                concurrency_permit = {};
                 try {
                     write_response(std::move(response_f.get0()), std::move(mem_permit), _compression);
                     _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
@@ -754,6 +823,16 @@ future<> cql_server::connection::process_request() {
                 }
             });
 
+            if (op == uint8_t(cql_binary_opcode::STARTUP)) {
+                // STARTUP may switch the connection to segment framing, so
+                // we can't read the next frame before it's processed.
+                return f.then([this] {
+                    if (_segment_codec) {
+                        _read_buf = make_segment_input_stream(std::move(_read_buf), _compression);
+                    }
+                });
+            }
+            (void)f;
             return make_ready_future<>();
           });
         });
@@ -789,6 +868,9 @@ future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_
 {
     using namespace compression_buffers;
     if (flags & cql_frame_flags::compression) {
+        if (_segment_codec) {
+            throw exceptions::protocol_exception("Compressed frames are not allowed with segment framing");
+        }
         if (_compression == cql_compression::lz4) {
             if (length < 4) {
                 throw std::runtime_error("Truncated frame");
@@ -873,6 +955,12 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_st
             cql_proto_exts.set(ext);
         }
     }
+    if (cql_proto_exts.contains(cql_protocol_extension::SEGMENT_FRAMING)) {
+        if (_compression == cql_compression::snappy) {
+            throw exceptions::protocol_exception("Segment framing is not supported with Snappy compression");
+        }
+        _segment_framing_requested = true;
+    }
     _client_state.set_protocol_extensions(std::move(cql_proto_exts));
     std::unique_ptr<cql_server::response> res;
     if (auto& a = client_state.get_auth_service()->underlying_authenticator(); a.require_authentication()) {
@@ -941,15 +1029,26 @@ template<typename Process>
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 cql_server::connection::process_on_shard(unsigned shard, uint16_t stream, fragmented_temporary_buffer::istream is,
         service::client_state& cs, service_permit permit, tracing::trace_state_ptr trace_state, Process process_fn) {
+    ++_server._stats.requests_bounced;
+    // The request is read on the target shard directly from this shard's
+    // buffer, which outlives the call, so it isn't copied.
     return _server.container().invoke_on(shard, _server._config.bounce_request_smp_service_group,
             [this, is = std::move(is), cs = cs.move_to_other_shard(), stream, permit = std::move(permit), process_fn,
-             gt = tracing::global_trace_state_ptr(std::move(trace_state))] (cql_server& server) {
-        service::client_state client_state = cs.get();
-        return do_with(bytes_ostream(), std::move(client_state), [this, &server, is = std::move(is), stream, process_fn,
-                                                                  trace_state = tracing::trace_state_ptr(gt)]
-                                              (bytes_ostream& linearization_buffer, service::client_state& client_state) mutable {
+             &cached = _shard_client_states[shard], gt = tracing::global_trace_state_ptr(std::move(trace_state))] (cql_server& server) {
+        if (!cached) {
+            cached = make_foreign(std::make_unique<shard_client_state>());
+        }
+        auto& local = cached->client_state;
+        if (!local || local->generation() != cs.generation()) {
+            // Requests still using the old copy keep it alive.
+            local = make_lw_shared<service::client_state>(cs.get());
+            ++server._stats.bounced_client_state_copies;
+        }
+        return do_with(bytes_ostream(), local, [this, &server, is = std::move(is), stream, process_fn,
+                                                trace_state = tracing::trace_state_ptr(gt)]
+                                              (bytes_ostream& linearization_buffer, lw_shared_ptr<service::client_state>& client_state) mutable {
             request_reader in(is, linearization_buffer);
-            return process_fn(client_state, server._query_processor, in, stream, _version, _cql_serialization_format,
+            return process_fn(*client_state, server._query_processor, in, stream, _version, _cql_serialization_format,
                     /* FIXME */empty_service_permit(), std::move(trace_state), false).then([] (auto msg) {
                 // result here has to be foreign ptr
                 return std::get<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::move(msg));
@@ -1547,26 +1646,92 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
 
 void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
 {
-    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
-        auto message = response->make_message(_version, compression);
-        message.on_delete([response = std::move(response)] { });
-        return _write_buf.write(std::move(message)).then([this] {
-            return _write_buf.flush();
+    auto res_op = response->opcode();
+    _pending_responses.push_back(pending_response{std::move(response), std::move(permit), compression, bool(_segment_codec)});
+    if (_pending_responses.size() == 1) {
+        // Responses which become ready while a write is in progress are
+        // written together with a single scatter/gather write once it
+        // completes. If other requests on this connection are still being
+        // processed, also let them complete within this reactor tick, so
+        // that pipelining clients get their responses coalesced.
+        bool defer = _pending_requests_gate.get_count() > 1;
+        _ready_to_respond = _ready_to_respond.then([this, defer] {
+            if (defer) {
+                return later().then([this] {
+                    return flush_responses();
+                });
+            }
+            return flush_responses();
         });
+    }
+    if (_segment_framing_requested && !_segment_codec && (res_op == cql_binary_opcode::READY || res_op == cql_binary_opcode::AUTHENTICATE)) {
+        // The response to STARTUP is the last one sent as a bare frame.
+        _segment_codec.emplace(_compression);
+    }
+}
+
+future<> cql_server::connection::flush_responses()
+{
+    auto responses = std::exchange(_pending_responses, {});
+    scattered_message<char> message;
+    std::optional<segment_writer> writer;
+    auto finish_segments = [&] {
+        if (!writer) {
+            return;
+        }
+        auto out = std::move(*writer).finish();
+        writer.reset();
+        for (auto&& fragment : out.fragments()) {
+            message.append_static(reinterpret_cast<const char*>(fragment.data()), fragment.size());
+        }
+        message.on_delete([out = std::move(out)] { });
+    };
+    for (auto& r : responses) {
+        if (r.segmented) {
+            if (!writer) {
+                writer.emplace(*_segment_codec);
+            }
+            bytes_ostream envelope;
+            r.response->write_envelope(_version, envelope);
+            writer->write_envelope(std::move(envelope));
+        } else {
+            finish_segments();
+            r.response->append_to_message(message, _version, r.compression);
+        }
+    }
+    finish_segments();
+
+    ++_server._stats.response_flushes;
+    _server._stats.responses_flushed += responses.size();
+    _server._stats.response_bytes_flushed += message.size();
+
+    message.on_delete([responses = std::move(responses)] { });
+    return _write_buf.write(std::move(message)).then([this] {
+        return _write_buf.flush();
     });
 }
 
 scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
+    scattered_message<char> msg;
+    append_to_message(msg, version, compression);
+    return msg;
+}
+
+void cql_server::response::append_to_message(scattered_message<char>& msg, uint8_t version, cql_compression compression) {
     if (compression != cql_compression::none) {
         compress(compression);
     }
-    scattered_message<char> msg;
     auto frame = make_frame(version, _body.size());
     msg.append(std::move(frame));
     for (auto&& fragment : _body.fragments()) {
         msg.append_static(reinterpret_cast<const char*>(fragment.data()), fragment.size());
     }
-    return msg;
+}
+
+void cql_server::response::write_envelope(uint8_t version, bytes_ostream& out) const {
+    auto frame = make_frame(version, _body.size());
+    out.write(frame.data(), frame.size());
+    out.append(_body);
 }
 
 void cql_server::response::compress(cql_compression compression)
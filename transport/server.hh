@@ -40,6 +40,8 @@
 #include "service_permit.hh"
 #include <seastar/core/sharded.hh>
 #include "utils/updateable_value.hh"
+#include "utils/adaptive_concurrency_limiter.hh"
+#include "transport/segment.hh"
 
 namespace scollectd {
 
@@ -116,7 +118,7 @@ struct cql_server_config {
 };
 
 class cql_server : public seastar::peering_sharded_service<cql_server> {
-private:
+public:
     struct transport_stats {
         // server stats
         uint64_t connects;
@@ -125,6 +127,11 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
         uint32_t requests_serving;
         uint64_t requests_blocked_memory;
         uint64_t requests_shed;
+        uint64_t requests_bounced;
+        uint64_t bounced_client_state_copies;
+        uint64_t response_flushes;
+        uint64_t responses_flushed;
+        uint64_t response_bytes_flushed;
 
         // cql message stats
         uint64_t startups;
@@ -148,6 +155,17 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
     cql_server_config _config;
     size_t _max_request_size;
     utils::updateable_value<uint32_t> _max_concurrent_requests;
+    utils::updateable_value<bool> _adaptive_concurrency_limit;
+    utils::adaptive_concurrency_limiter::config _concurrency_limiter_config;
+    struct concurrency_limiter {
+        utils::adaptive_concurrency_limiter limiter;
+        seastar::metrics::metric_groups metrics;
+
+        explicit concurrency_limiter(utils::adaptive_concurrency_limiter::config cfg) : limiter(cfg) { }
+    };
+    // Scheduling groups get separate limits, as they compete for resources
+    // independently of each other.
+    std::unordered_map<scheduling_group, concurrency_limiter> _concurrency_limiters;
     semaphore& _memory_available;
     seastar::metrics::metric_groups _metrics;
     std::unique_ptr<event_notifier> _notifier;
@@ -158,6 +176,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
     cql_server(distributed<cql3::query_processor>& qp, auth::service&,
             service::migration_notifier& mn, database& db,
             cql_server_config config);
+    const transport_stats& get_stats() const { return _stats; }
+private:
+    utils::adaptive_concurrency_limiter& get_concurrency_limiter(scheduling_group sg);
+public:
     future<> listen(socket_address addr, std::shared_ptr<seastar::tls::credentials_builder> = {}, bool is_shard_aware = false, bool keepalive = false);
     future<> do_accepts(int which, bool keepalive, socket_address server_addr);
     future<> stop();
@@ -181,8 +203,29 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
         cql_compression _compression = cql_compression::none;
         cql_serialization_format _cql_serialization_format = cql_serialization_format::latest();
         service::client_state _client_state;
+        // Copies of _client_state used by requests bounced to other shards,
+        // indexed by shard. Each copy lives on (and is only accessed from)
+        // its own shard and is refreshed when _client_state changes.
+        struct shard_client_state {
+            lw_shared_ptr<service::client_state> client_state;
+        };
+        std::vector<foreign_ptr<std::unique_ptr<shard_client_state>>> _shard_client_states;
         std::unordered_map<uint16_t, cql_query_state> _query_states;
         unsigned _request_cpu = 0;
+        // Set when the client asked for segment framing in STARTUP; framing
+        // switches once the response to STARTUP is on its way.
+        bool _segment_framing_requested = false;
+        // Engaged once the connection uses segment framing.
+        std::optional<segment_codec> _segment_codec;
+
+        struct pending_response {
+            foreign_ptr<std::unique_ptr<cql_server::response>> response;
+            service_permit permit;
+            cql_compression compression;
+            bool segmented;
+        };
+        // Responses waiting to be coalesced into the next write.
+        std::vector<pending_response> _pending_responses;
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -256,6 +299,7 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
                 service_permit permit, tracing::trace_state_ptr trace_state, Process process_fn);
 
         void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none);
+        future<> flush_responses();
 
         void init_cql_serialization_format();
 
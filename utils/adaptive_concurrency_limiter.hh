@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2021 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace utils {
+
+/*
+ * Limits the number of concurrently executing requests, adapting the limit
+ * to the observed service latency.
+ *
+ * The limiter keeps two exponentially averaged latencies: a short-term one,
+ * which follows the current latency closely, and a long-term one, which
+ * approximates the latency of an unloaded system. When the short-term latency
+ * grows above the long-term one, requests are queueing somewhere in the system
+ * and the limit is decreased proportionally (the "gradient"); otherwise it is
+ * allowed to grow by a small queue allowance. Requests which time out feed
+ * their (large) latency into the averages, which quickly drives the limit down.
+ *
+ * Requests which don't fit in the limit should be rejected right away, rather
+ * than queued, so that a degraded node sheds load early instead of letting it
+ * pile up until it times out.
+ */
+class adaptive_concurrency_limiter {
+public:
+    struct config {
+        uint32_t min_limit = 16;
+        uint32_t max_limit = 10000;
+        uint32_t initial_limit = 100;
+        // How much the short-term latency may exceed the long-term one before
+        // the limit starts to decrease.
+        double tolerance = 1.5;
+        // Weight of a new sample in the short-term and long-term averages.
+        double short_window_weight = 0.1;
+        double long_window_weight = 0.002;
+        // Weight of a newly computed limit in the smoothed limit.
+        double smoothing = 0.2;
+    };
+private:
+    config _cfg;
+    double _limit;
+    uint32_t _in_flight = 0;
+    double _short_latency = 0;
+    double _long_latency = 0;
+    uint64_t _rejected = 0;
+private:
+    static double update_average(double avg, double sample, double weight) {
+        return avg ? avg * (1 - weight) + sample * weight : sample;
+    }
+
+    void set_limit(double limit) {
+        _limit = std::clamp(limit, double(_cfg.min_limit), double(_cfg.max_limit));
+    }
+public:
+    // Holds an admitted request, releasing it with the time elapsed since
+    // admission on destruction.
+    class permit {
+        using clock_type = std::chrono::steady_clock;
+        adaptive_concurrency_limiter* _limiter = nullptr;
+        clock_type::time_point _start;
+    public:
+        permit() = default;
+        explicit permit(adaptive_concurrency_limiter& limiter)
+            : _limiter(&limiter)
+            , _start(clock_type::now())
+        { }
+        permit(permit&& o) noexcept
+            : _limiter(std::exchange(o._limiter, nullptr))
+            , _start(o._start)
+        { }
+        permit& operator=(permit&& o) noexcept {
+            if (this != &o) {
+                this->~permit();
+                new (this) permit(std::move(o));
+            }
+            return *this;
+        }
+        ~permit() {
+            if (_limiter) {
+                _limiter->release(clock_type::now() - _start);
+            }
+        }
+        explicit operator bool() const {
+            return _limiter;
+        }
+    };
+
+    adaptive_concurrency_limiter() : adaptive_concurrency_limiter(config{}) { }
+
+    explicit adaptive_concurrency_limiter(config cfg)
+        : _cfg(cfg)
+        , _limit(std::clamp(cfg.initial_limit, cfg.min_limit, cfg.max_limit))
+    { }
+
+    // Returns true if the request is admitted. Each admitted request must be
+    // followed by exactly one call to release().
+    bool try_acquire() {
+        if (_in_flight >= limit()) {
+            ++_rejected;
+            return false;
+        }
+        ++_in_flight;
+        return true;
+    }
+
+    // Like try_acquire(), but returns a permit which releases the request
+    // when destroyed. The permit is disengaged if the request is rejected.
+    permit try_get_permit() {
+        return try_acquire() ? permit(*this) : permit();
+    }
+
+    // Completes a request which was served in `latency`.
+    void release(std::chrono::nanoseconds latency) {
+        auto in_flight = _in_flight--;
+        auto sample = double(latency.count());
+        _short_latency = update_average(_short_latency, sample, _cfg.short_window_weight);
+        _long_latency = update_average(_long_latency, sample, _cfg.long_window_weight);
+
+        // If the long-term latency drifted far above the short-term one
+        // (e.g. after a load spike subsided), let it recover quickly.
+        if (_long_latency > _short_latency * 2) {
+            _long_latency = _short_latency * 2;
+        }
+
+        auto gradient = _short_latency > 0 ? std::clamp(_cfg.tolerance * _long_latency / _short_latency, 0.5, 1.0) : 1.0;
+        auto queue_allowance = std::sqrt(_limit);
+        auto new_limit = _limit * (1 - _cfg.smoothing) + (_limit * gradient + queue_allowance) * _cfg.smoothing;
+
+        // Don't grow the limit when it isn't what restricts the load, or the
+        // limit would grow without bound on an underutilized node.
+        if (new_limit > _limit && in_flight < _limit / 2) {
+            return;
+        }
+        set_limit(new_limit);
+    }
+
+    uint32_t limit() const {
+        return uint32_t(_limit);
+    }
+
+    uint32_t in_flight() const {
+        return _in_flight;
+    }
+
+    // Number of requests rejected by try_acquire().
+    uint64_t rejected() const {
+        return _rejected;
+    }
+
+    const config& get_config() const {
+        return _cfg;
+    }
+
+    void set_config(config cfg) {
+        _cfg = cfg;
+        set_limit(_limit);
+    }
+};
+
+}
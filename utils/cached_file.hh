@@ -102,9 +102,11 @@ class cached_file {
         auto size = idx == _last_page ? _last_page_size : page_size;
         return _file.dma_read_exactly<char>(idx * page_size, size, pc)
             .then([this, idx] (temporary_buffer<char>&& buf) mutable {
-                ++_metrics.page_populations;
-                _metrics.cached_bytes += buf.size();
-                _cache.emplace(idx, cached_page(buf.share()));
+                // Another reader of a shared instance may have populated the page meanwhile.
+                if (_cache.emplace(idx, cached_page(buf.share())).second) {
+                    ++_metrics.page_populations;
+                    _metrics.cached_bytes += buf.size();
+                }
                 return std::move(buf);
             });
     }
@@ -255,6 +255,17 @@ class approx_exponential_histogram {
         return *this;
     }
 
+    /*!
+     * \brief subtract an earlier state of the current histogram from it,
+     * leaving only the values inserted since.
+     */
+    approx_exponential_histogram& subtract(const approx_exponential_histogram& b) {
+        for (size_t i = 0; i < NUM_BUCKETS; i++) {
+            _buckets[i] -= std::min(_buckets[i], b.get(i));
+        }
+        return *this;
+    }
+
     template<uint64_t A, uint64_t B, size_t C>
     friend approx_exponential_histogram<A, B, C> merge(approx_exponential_histogram<A, B, C> a, const approx_exponential_histogram<A, B, C>& b);
 
@@ -47,12 +47,21 @@
 
 #include "bytes.hh"
 
+#include <seastar/core/byteorder.hh>
+
+#include <bit>
 #include <cstdint>
 
 using vint_size_type = bytes::size_type;
 
 static constexpr size_t max_vint_length = 9;
 
+template <typename T>
+struct deserialized_vint {
+    T value;
+    vint_size_type size;
+};
+
 struct unsigned_vint final {
     using value_type = uint64_t;
 
@@ -62,6 +71,10 @@ struct unsigned_vint final {
 
     static value_type deserialize(bytes_view v);
 
+    // Decodes the vint at the front of v along with its size, in a single pass
+    // over its first byte. v must hold at least the whole vint.
+    static deserialized_vint<value_type> deserialize_with_size(bytes_view v) noexcept;
+
     static vint_size_type serialized_size_from_first_byte(bytes::value_type first_byte);
 };
 
@@ -74,5 +87,42 @@ struct signed_vint final {
 
     static value_type deserialize(bytes_view v);
 
+    static deserialized_vint<value_type> deserialize_with_size(bytes_view v) noexcept;
+
     static vint_size_type serialized_size_from_first_byte(bytes::value_type first_byte);
 };
+
+// Inline, since it's on the hot path of parsing sstables.
+inline deserialized_vint<uint64_t> unsigned_vint::deserialize_with_size(bytes_view v) noexcept {
+    const int8_t first_byte = v.front();
+
+    // No additional bytes, since the most significant bit is not set.
+    if (first_byte >= 0) {
+        return {uint64_t(first_byte), 1};
+    }
+
+    const vint_size_type extra_bytes_size = std::countl_one(uint8_t(first_byte));
+
+    uint64_t rest;
+    // If we can overread do that. A single 64-bit read whose unneeded part is
+    // shifted out is cheaper than reading the extra bytes one by one.
+    if (__builtin_expect(v.size() >= sizeof(uint64_t) + 1, true)) {
+        rest = seastar::read_be<uint64_t>(reinterpret_cast<const char*>(v.data() + 1)) >> (64 - extra_bytes_size * 8);
+    } else {
+        rest = 0;
+        for (vint_size_type i = 1; i <= extra_bytes_size; ++i) {
+            rest = (rest << 8) | uint8_t(v[i]);
+        }
+    }
+
+    // The bits of the first byte not used for counting bytes, which are all
+    // used for counting when there are 8 extra bytes.
+    const auto first = uint64_t(uint8_t(first_byte) & (0xff >> extra_bytes_size));
+    return {(first << ((extra_bytes_size * 8) % 64)) | rest, extra_bytes_size + 1};
+}
+
+inline deserialized_vint<int64_t> signed_vint::deserialize_with_size(bytes_view v) noexcept {
+    const auto [un, size] = unsigned_vint::deserialize_with_size(v);
+    // Zig-zag decoding.
+    return {static_cast<int64_t>((un >> 1) ^ -(un & 1)), size};
+}